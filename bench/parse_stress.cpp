@@ -0,0 +1,101 @@
+// Times version::parse on pathological inputs of growing size. With the
+// limits lifted the time per byte stays flat, showing the scan is linear;
+// with the default limits the rejection time stays flat in absolute terms.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "sk/semver.hpp"
+
+
+namespace {
+
+
+struct unbounded_parsing_policy final {
+    constexpr static bool kAllowPrefix  = false;
+    constexpr static bool kAllowPartial = false;
+
+    constexpr static sk::parse_limits kLimits = {
+        std::numeric_limits<std::size_t>::max(),
+        20,
+        std::numeric_limits<std::size_t>::max(),
+        std::numeric_limits<std::size_t>::max(),
+        std::numeric_limits<std::size_t>::max(),
+    };
+};
+
+
+struct stress_case final {
+    const char* name;
+    std::string (*make)(std::size_t size);
+};
+
+
+std::string
+repeat(std::string_view unit, std::size_t size) {
+    std::string result;
+    result.reserve(size + unit.size());
+    while (result.size() < size)
+        result.append(unit);
+    return result;
+}
+
+
+const stress_case kCases[] = {
+    { "long identifier",     [](std::size_t n) { return "1.0.0-" + repeat("a", n); } },
+    { "many identifiers",    [](std::size_t n) { return "1.0.0-" + repeat("a.", n) + "a"; } },
+    { "near miss",           [](std::size_t n) { return "1.0.0-" + repeat("a.", n) + "!"; } },
+    { "numeric identifiers", [](std::size_t n) { return "1.0.0-" + repeat("1.", n) + "1"; } },
+    { "long build",          [](std::size_t n) { return "1.0.0+" + repeat("0-", n); } },
+    { "trailing dots",       [](std::size_t n) { return "1.0.0-a" + repeat(".", n); } },
+};
+
+
+template<typename Policy>
+double
+nanosPerCall(const std::string& text, std::size_t iterations) {
+    using clock = std::chrono::steady_clock;
+
+    std::size_t accepted = 0;
+    const auto start = clock::now();
+    for (std::size_t index = 0; index < iterations; ++index) {
+        try {
+            accepted += sk::version<Policy>::parse(text).major() + 1;
+        } catch (const std::invalid_argument&) {
+        }
+    }
+
+    const auto elapsed = std::chrono::duration<double, std::nano>(clock::now() - start);
+    if (accepted == std::numeric_limits<std::size_t>::max())
+        std::puts("");
+    return elapsed.count() / static_cast<double>(iterations);
+}
+
+
+} // namespace
+
+
+int main() {
+    const std::vector<std::size_t> sizes = { 1 << 10, 1 << 14, 1 << 17, 1 << 20 };
+
+    std::printf("%-20s %10s %14s %10s %16s\n",
+                "case", "bytes", "unbounded ns", "ns/byte", "default ns");
+    for (const auto& stress : kCases) {
+        for (auto size : sizes) {
+            const auto text       = stress.make(size);
+            const auto iterations = std::max<std::size_t>(4, (1 << 24) / text.size());
+
+            const auto unbounded = nanosPerCall<unbounded_parsing_policy>(text, iterations);
+            const auto limited   = nanosPerCall<sk::detail::strict_version_parsing_policy>(text, iterations);
+            std::printf("%-20s %10zu %14.0f %10.3f %16.1f\n",
+                        stress.name, text.size(), unbounded,
+                        unbounded / static_cast<double>(text.size()), limited);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
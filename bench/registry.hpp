@@ -0,0 +1,349 @@
+#ifndef SK_SEMVER_BENCH_REGISTRY_HPP
+#define SK_SEMVER_BENCH_REGISTRY_HPP
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace sk::bench {
+
+
+// Shape of a synthetic registry. Everything is derived from the seed with a
+// self-contained generator that only uses integer and exactly rounded
+// floating point operations, so a given set of options yields the same
+// registry on every platform and standard library.
+struct registry_options final {
+    std::uint64_t seed               = 1;
+    std::size_t   packages           = 10000;
+    double        mean_versions      = 24.0;
+    double        major_bump_ratio   = 0.04;
+    double        minor_bump_ratio   = 0.25;
+    double        prerelease_ratio   = 0.15;
+    double        build_ratio        = 0.05;
+    double        mean_dependencies  = 4.0;
+    double        alternatives_ratio = 0.1;
+    double        conflict_ratio     = 0.05;
+    double        advisory_ratio     = 0.05;
+};
+
+
+inline constexpr const char* kOptionsUsage =
+    "[--seed N] [--packages N] [--versions MEAN]\n"
+    "    [--major-bump RATIO] [--minor-bump RATIO] [--prerelease RATIO]\n"
+    "    [--build RATIO] [--dependencies MEAN] [--alternatives RATIO]\n"
+    "    [--conflicts RATIO] [--advisories RATIO]\n";
+
+
+struct release final {
+    std::uint32_t package;
+    std::string   version;
+};
+
+
+struct core final {
+    std::uint64_t major;
+    std::uint64_t minor;
+    std::uint64_t patch;
+};
+
+
+// One alternative of a range: '^' and '~' as in npm, '=' pins a version.
+struct constraint final {
+    char op;
+    core version;
+};
+
+
+struct dependency final {
+    std::uint32_t dependent;
+    std::uint32_t package;
+
+    // Release of package the dependent has locked today, which a conflict
+    // leaves outside the range.
+    core locked;
+
+    // Alternatives joined by "||", never empty.
+    std::vector<constraint> any_of;
+};
+
+
+// Releases of package in [introduced, fixed) are affected.
+struct advisory final {
+    std::uint32_t package;
+    core          introduced;
+    core          fixed;
+};
+
+
+struct registry final {
+    std::vector<std::string> packages;
+
+    // Publish order: each package's history is ascending, packages interleave.
+    std::vector<release> releases;
+
+    // Dependents only depend on packages generated before them, so the
+    // graph is acyclic and early packages are the popular ones.
+    std::vector<dependency> dependencies;
+
+    std::vector<advisory> advisories;
+};
+
+
+inline std::string
+coreText(const core& value) {
+    return std::to_string(value.major) + "." +
+           std::to_string(value.minor) + "." +
+           std::to_string(value.patch);
+}
+
+
+inline std::string
+rangeText(const dependency& value) {
+    std::string text;
+    for (const auto& alternative : value.any_of) {
+        if (!text.empty()) text.append(" || ");
+        text.append(1, alternative.op).append(coreText(alternative.version));
+    }
+
+    return text;
+}
+
+
+class random final {
+public:
+    explicit random(std::uint64_t seed) noexcept
+        : state_(seed) {}
+
+    // splitmix64.
+    std::uint64_t
+    next() noexcept {
+        auto value = (state_ += 0x9e3779b97f4a7c15ull);
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+        return value ^ (value >> 31);
+    }
+
+    double
+    uniform() noexcept {
+        return static_cast<double>(next() >> 11) * 0x1.0p-53;
+    }
+
+    bool
+    chance(double probability) noexcept {
+        return uniform() < probability;
+    }
+
+    std::uint64_t
+    below(std::uint64_t bound) noexcept {
+        return next() % bound;
+    }
+
+    // Geometric count with the given mean, at least one. Drawn as a run of
+    // trials instead of through std::log, whose result varies between libms.
+    std::size_t
+    geometric(double mean) noexcept {
+        const double stop = 1.0 / mean;
+        std::size_t  count = 1;
+        while (!chance(stop))
+            ++count;
+        return count;
+    }
+
+private:
+    std::uint64_t state_;
+};
+
+
+inline std::string
+packageName(random& rng, std::size_t index) {
+    constexpr const char* kScopes[] = { "core", "tools", "infra", "web", "data" };
+
+    std::string name;
+    if (rng.chance(0.3))
+        name.append("@").append(kScopes[rng.below(std::size(kScopes))]).append("/");
+    return name.append("pkg-").append(std::to_string(index));
+}
+
+
+// Appends a package's releases to out and its non-prerelease cores to
+// stable, both ascending.
+inline void
+appendHistory(random& rng,
+              const registry_options& options,
+              std::uint32_t package,
+              std::vector<release>& out,
+              std::vector<core>& stable) {
+    constexpr const char* kChannels[] = { "alpha", "beta", "rc" };
+
+    std::uint64_t major = rng.chance(0.5) ? 0 : 1;
+    std::uint64_t minor = major == 0 ? 1 : 0;
+    std::uint64_t patch = 0;
+    const auto count = rng.geometric(options.mean_versions);
+    for (std::size_t index = 0; index < count; ++index) {
+        stable.push_back({ major, minor, patch });
+        const auto core = coreText(stable.back());
+
+        if (rng.chance(options.prerelease_ratio)) {
+            const auto channels = 1 + rng.below(std::size(kChannels));
+            for (std::size_t channel = 0; channel < channels; ++channel) {
+                const auto builds = 1 + rng.below(3);
+                for (std::size_t build = 1; build <= builds; ++build)
+                    out.push_back({ package, core + "-" + kChannels[channel] + "." + std::to_string(build) });
+            }
+        }
+
+        auto text = core;
+        if (rng.chance(options.build_ratio)) {
+            char sha[8];
+            std::snprintf(sha, sizeof(sha), "%07llx",
+                          static_cast<unsigned long long>(rng.below(0x10000000)));
+            text.append("+sha.").append(sha);
+        }
+
+        out.push_back({ package, std::move(text) });
+
+        if (rng.chance(options.major_bump_ratio)) {
+            ++major;
+            minor = patch = 0;
+        } else if (rng.chance(options.minor_bump_ratio)) {
+            ++minor;
+            patch = 0;
+        } else {
+            ++patch;
+        }
+    }
+}
+
+
+// Picks a range over target's releases for dependent. Most ranges are a
+// caret or tilde on the locked release, some add an alternative on another
+// release and conflicts ask for a major that was never published.
+inline dependency
+makeDependency(random& rng,
+               const registry_options& options,
+               std::uint32_t dependent,
+               std::uint32_t target,
+               const std::vector<core>& stable) {
+    dependency result{ dependent, target, stable[rng.below(stable.size())], {} };
+    if (rng.chance(options.conflict_ratio)) {
+        result.any_of.push_back({ '^', { stable.back().major + 1, 0, 0 } });
+        return result;
+    }
+
+    const auto pick = [&](const core& version) {
+        const char op = rng.chance(0.6) ? '^' : rng.chance(0.75) ? '~' : '=';
+        result.any_of.push_back({ op, version });
+    };
+
+    pick(result.locked);
+    if (rng.chance(options.alternatives_ratio))
+        pick(stable[rng.below(stable.size())]);
+    return result;
+}
+
+
+inline registry
+generate(const registry_options& options) {
+    random rng{ options.seed };
+    registry result;
+
+    std::vector<std::vector<release>> histories(options.packages);
+    std::vector<std::vector<core>>    stables(options.packages);
+    for (std::size_t index = 0; index < options.packages; ++index) {
+        const auto package = static_cast<std::uint32_t>(index);
+        result.packages.push_back(packageName(rng, index));
+        appendHistory(rng, options, package, histories[index], stables[index]);
+
+        const auto& stable = stables[index];
+        if (stable.size() > 1 && rng.chance(options.advisory_ratio)) {
+            const auto introduced = rng.below(stable.size() - 1);
+            const auto fixed      = introduced + 1 + rng.below(stable.size() - introduced - 1);
+            result.advisories.push_back({ package, stable[introduced], stable[fixed] });
+        }
+
+        if (index == 0)
+            continue;
+
+        // Skewed towards low indices, a few packages are depended on a lot.
+        const auto count = rng.geometric(options.mean_dependencies + 1.0) - 1;
+        for (std::size_t edge = 0; edge < count; ++edge) {
+            const auto target = static_cast<std::uint32_t>(rng.below(1 + rng.below(index)));
+            result.dependencies.push_back(makeDependency(rng, options, package, target, stables[target]));
+        }
+    }
+
+    // Interleave histories into a feed, keeping each package's own order.
+    std::vector<std::size_t> cursors(options.packages, 0);
+    std::vector<std::size_t> pending;
+    for (std::size_t index = 0; index < options.packages; ++index)
+        if (!histories[index].empty()) pending.push_back(index);
+
+    while (!pending.empty()) {
+        const auto slot    = rng.below(pending.size());
+        const auto package = pending[slot];
+        result.releases.push_back(std::move(histories[package][cursors[package]++]));
+        if (cursors[package] == histories[package].size()) {
+            pending[slot] = pending.back();
+            pending.pop_back();
+        }
+    }
+
+    return result;
+}
+
+
+// Reads "--name value" pairs shared by the generator and the benchmark,
+// throws std::invalid_argument on an unknown flag, a missing value or a value
+// out of range.
+inline registry_options
+parseOptions(int argc, char** argv) {
+    const auto ratio = [](const std::string& name, const char* value) {
+        const auto result = std::stod(value);
+        if (!(result >= 0.0 && result <= 1.0))
+            throw std::invalid_argument(name + " must be between 0 and 1");
+        return result;
+    };
+
+    const auto mean = [](const std::string& name, const char* value, double least) {
+        const auto result = std::stod(value);
+        if (!(result >= least && result <= 1e6))
+            throw std::invalid_argument(name + " must be between " + std::to_string(least) + " and 1e6");
+        return result;
+    };
+
+    registry_options options;
+    for (int index = 1; index < argc; index += 2) {
+        const std::string name = argv[index];
+        if (index + 1 == argc)
+            throw std::invalid_argument("Missing value for " + name);
+
+        const char* value = argv[index + 1];
+        if      (name == "--seed")         options.seed               = std::stoull(value);
+        else if (name == "--packages")     options.packages           = std::stoull(value);
+        else if (name == "--versions")     options.mean_versions      = mean(name, value, 1.0);
+        else if (name == "--major-bump")   options.major_bump_ratio   = ratio(name, value);
+        else if (name == "--minor-bump")   options.minor_bump_ratio   = ratio(name, value);
+        else if (name == "--prerelease")   options.prerelease_ratio   = ratio(name, value);
+        else if (name == "--build")        options.build_ratio        = ratio(name, value);
+        else if (name == "--dependencies") options.mean_dependencies  = mean(name, value, 0.0);
+        else if (name == "--alternatives") options.alternatives_ratio = ratio(name, value);
+        else if (name == "--conflicts")    options.conflict_ratio     = ratio(name, value);
+        else if (name == "--advisories")   options.advisory_ratio     = ratio(name, value);
+        else throw std::invalid_argument("Unknown option " + name);
+    }
+
+    if (options.packages > std::numeric_limits<std::uint32_t>::max())
+        throw std::invalid_argument("--packages must fit in 32 bits");
+
+    return options;
+}
+
+
+} // namespace sk::bench
+
+#endif // SK_SEMVER_BENCH_REGISTRY_HPP
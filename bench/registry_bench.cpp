@@ -0,0 +1,203 @@
+// Times the library's hot paths over a synthetic registry, takes the same
+// options as semver_registry_gen so runs are reproducible from the seed.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <vector>
+
+#include "registry.hpp"
+#include "sk/semver.hpp"
+#include "sk/semver/latest.hpp"
+#include "sk/semver/sketch.hpp"
+#include "sk/semver/upgrade.hpp"
+
+
+namespace {
+
+
+using version      = sk::version<>;
+using interval_set = sk::version_interval_set<version>;
+
+
+// The lowest version with this core, the exclusive upper bound of a range.
+version
+floorOf(std::uint64_t major, std::uint64_t minor, std::uint64_t patch) {
+    return version(major, minor, patch, sk::prerelease{ "0" });
+}
+
+
+// Compiles the alternatives of a dependency the way npm reads them.
+interval_set
+compileRange(const sk::bench::dependency& dependency) {
+    std::vector<sk::version_interval<version>> intervals;
+    for (const auto& alternative : dependency.any_of) {
+        const auto& [major, minor, patch] = alternative.version;
+
+        version upper;
+        if      (alternative.op == '=') upper = floorOf(major, minor, patch + 1);
+        else if (alternative.op == '~') upper = floorOf(major, minor + 1, 0);
+        else if (major != 0)            upper = floorOf(major + 1, 0, 0);
+        else if (minor != 0)            upper = floorOf(0, minor + 1, 0);
+        else                            upper = floorOf(0, 0, patch + 1);
+
+        intervals.push_back({ version(major, minor, patch), std::move(upper) });
+    }
+
+    return interval_set{ std::move(intervals) };
+}
+
+
+template<typename Body>
+void
+measure(const char* name, std::size_t operations, Body&& body) {
+    using clock = std::chrono::steady_clock;
+
+    const auto start   = clock::now();
+    const auto checked = body();
+    const auto elapsed = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+    std::printf("%-24s %12zu ops %10.1f ns/op %14.0f ops/s  [%zu]\n",
+                name, operations, elapsed / static_cast<double>(operations),
+                static_cast<double>(operations) * 1e9 / elapsed,
+                static_cast<std::size_t>(checked));
+}
+
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    sk::bench::registry_options options;
+    try {
+        options = sk::bench::parseOptions(argc, argv);
+    } catch (const std::exception& error) {
+        std::fprintf(stderr, "%s: %s\nusage: %s %s", argv[0], error.what(), argv[0],
+                     sk::bench::kOptionsUsage);
+        return EXIT_FAILURE;
+    }
+
+    const auto registry = sk::bench::generate(options);
+    const auto count    = registry.releases.size();
+
+    std::printf("seed %llu, %zu packages, %zu releases, %zu dependencies, %zu advisories\n",
+                static_cast<unsigned long long>(options.seed),
+                registry.packages.size(), count,
+                registry.dependencies.size(), registry.advisories.size());
+
+    std::vector<sk::version<>> versions;
+    versions.reserve(count);
+    measure("version::parse", count, [&] {
+        for (const auto& release : registry.releases)
+            versions.push_back(sk::version<>::parse(release.version));
+        return versions.size();
+    });
+
+    std::vector<sk::static_version<32>> statics;
+    statics.reserve(count);
+    measure("static_version::parse", count, [&] {
+        for (const auto& release : registry.releases)
+            statics.push_back(sk::static_version<32>::parse(release.version));
+        return statics.size();
+    });
+
+    measure("version sort", count, [&] {
+        auto sorted = versions;
+        std::sort(sorted.begin(), sorted.end());
+        return sorted.front().major();
+    });
+
+    measure("static_version sort", count, [&] {
+        auto sorted = statics;
+        std::sort(sorted.begin(), sorted.end());
+        return sorted.front().major();
+    });
+
+    measure("latest_versions feed", count, [&] {
+        sk::latest_versions<> latest;
+        std::size_t changes = 0;
+        for (std::size_t index = 0; index < count; ++index)
+            changes += latest.update(registry.packages[registry.releases[index].package],
+                                     versions[index]);
+        return changes;
+    });
+
+    measure("cardinality sketch", count, [&] {
+        sk::version_cardinality_sketch<> sketch;
+        for (const auto& version : versions)
+            sketch.add(version);
+        return static_cast<std::size_t>(sketch.estimate());
+    });
+
+    measure("quantile sketch", count, [&] {
+        sk::version_quantile_sketch<sk::static_version<32>> sketch;
+        for (const auto& version : statics)
+            sketch.add(version);
+        return static_cast<std::size_t>(sketch.quantile(0.05).major());
+    });
+
+    std::vector<std::vector<version>> catalogs(registry.packages.size());
+    measure("catalog build", count, [&] {
+        for (std::size_t index = 0; index < count; ++index)
+            catalogs[registry.releases[index].package].push_back(versions[index]);
+        for (auto& catalog : catalogs)
+            std::sort(catalog.begin(), catalog.end());
+        return catalogs.size();
+    });
+
+    const auto dependencies = registry.dependencies.size();
+    std::vector<interval_set> ranges;
+    ranges.reserve(dependencies);
+    measure("range compile", dependencies, [&] {
+        for (const auto& dependency : registry.dependencies)
+            ranges.push_back(compileRange(dependency));
+        return ranges.size();
+    });
+
+    std::vector<interval_set> advisories(registry.packages.size());
+    for (const auto& advisory : registry.advisories) {
+        const auto& [major, minor, patch] = advisory.fixed;
+        advisories[advisory.package] = interval_set{ { {
+            version(advisory.introduced.major, advisory.introduced.minor, advisory.introduced.patch),
+            floorOf(major, minor, patch),
+        } } };
+    }
+
+    std::vector<sk::upgrade_query<version>>    upgrades;
+    std::vector<sk::satisfying_query<version>> lockfile;
+    for (std::size_t index = 0; index < dependencies; ++index) {
+        const auto& dependency = registry.dependencies[index];
+        const auto& [major, minor, patch] = dependency.locked;
+        upgrades.push_back({ &catalogs[dependency.package], &advisories[dependency.package],
+                             &ranges[index], version(major, minor, patch) });
+        lockfile.push_back({ &catalogs[dependency.package], &ranges[index] });
+    }
+
+    // The bracketed counts are the dependencies left unsatisfied, which
+    // conflicts and advisories drive up.
+    const auto unsatisfied = [](const std::vector<const version*>& results) {
+        return static_cast<std::size_t>(std::count(results.begin(), results.end(), nullptr));
+    };
+
+    measure("minimal_upgrades", dependencies, [&] {
+        return unsatisfied(sk::minimal_upgrades(upgrades));
+    });
+
+    measure("max_satisfying", dependencies, [&] {
+        std::vector<const version*> results;
+        results.reserve(dependencies);
+        for (const auto& query : lockfile)
+            results.push_back(sk::max_satisfying(*query.catalog, *query.allowed));
+        return unsatisfied(results);
+    });
+
+    measure("max_satisfying interleave", dependencies, [&] {
+        return unsatisfied(sk::max_satisfying_interleaved(lockfile));
+    });
+
+    measure("max_satisfying_batch", dependencies, [&] {
+        return unsatisfied(sk::max_satisfying_batch(lockfile));
+    });
+
+    return EXIT_SUCCESS;
+}
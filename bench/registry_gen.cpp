@@ -0,0 +1,44 @@
+// Writes a synthetic registry in three blocks separated by blank lines:
+// "package version" releases in publish order, "dependent package range"
+// dependencies and "package introduced fixed" advisories.
+//
+//   semver_registry_gen [--seed N] [--packages N] [--versions MEAN]
+//       [--major-bump RATIO] [--minor-bump RATIO] [--prerelease RATIO]
+//       [--build RATIO] [--dependencies MEAN] [--alternatives RATIO]
+//       [--conflicts RATIO] [--advisories RATIO]
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+
+#include "registry.hpp"
+
+
+int main(int argc, char** argv) {
+    sk::bench::registry_options options;
+    try {
+        options = sk::bench::parseOptions(argc, argv);
+    } catch (const std::exception& error) {
+        std::fprintf(stderr, "%s: %s\nusage: %s %s", argv[0], error.what(), argv[0],
+                     sk::bench::kOptionsUsage);
+        return EXIT_FAILURE;
+    }
+
+    const auto registry = sk::bench::generate(options);
+    for (const auto& release : registry.releases)
+        std::printf("%s %s\n", registry.packages[release.package].c_str(),
+                    release.version.c_str());
+
+    std::printf("\n");
+    for (const auto& dependency : registry.dependencies)
+        std::printf("%s %s %s\n", registry.packages[dependency.dependent].c_str(),
+                    registry.packages[dependency.package].c_str(),
+                    sk::bench::rangeText(dependency).c_str());
+
+    std::printf("\n");
+    for (const auto& advisory : registry.advisories)
+        std::printf("%s %s %s\n", registry.packages[advisory.package].c_str(),
+                    sk::bench::coreText(advisory.introduced).c_str(),
+                    sk::bench::coreText(advisory.fixed).c_str());
+
+    return EXIT_SUCCESS;
+}
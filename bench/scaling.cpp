@@ -0,0 +1,327 @@
+// Runs parse, compare and format workloads on 1..N threads and reports how
+// throughput scales. Every thread does the same amount of work, so perfect
+// scaling keeps the efficiency column at 1.0.
+//
+// To point at shared-state hotspots it counts heap allocations per
+// operation (each one is a potential trip through a contended malloc arena)
+// and copies of the global locale per operation (each one bumps a reference
+// count every thread shares). C++ has no hook on locale construction, so the
+// workloads count the locale holding objects they construct. A std::locale
+// probe measures whether those copies contend on this machine at all, and
+// only then are they blamed. Two control workloads, std::regex compiling and
+// matching and ostringstream formatting, take a locale per operation. The
+// library's own workloads should scale like neither of them.
+//
+//   semver_scaling [max threads] [operations per thread]
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <latch>
+#include <locale>
+#include <new>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "registry.hpp"
+#include "sk/semver.hpp"
+
+
+namespace {
+
+
+thread_local std::uint64_t tAllocations = 0;
+thread_local std::uint64_t tLocales     = 0;
+
+
+} // namespace
+
+
+void*
+operator new(std::size_t size) {
+    ++tAllocations;
+    if (void* memory = std::malloc(size ? size : 1))
+        return memory;
+    throw std::bad_alloc{};
+}
+
+
+// Out of line so the compiler does not pair inlined free() calls with
+// operator new and warn about a mismatch.
+[[gnu::noinline]] void
+operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+
+[[gnu::noinline]] void
+operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+
+namespace {
+
+
+struct inputs final {
+    std::vector<std::string>            texts;
+    std::vector<sk::version<>>          versions;
+    std::vector<sk::static_version<32>> statics;
+};
+
+
+struct workload final {
+    const char* name;
+    bool        control;
+
+    // Runs operations starting at offset, returns a value to keep it alive.
+    std::function<std::uint64_t(const inputs&, std::size_t offset, std::size_t operations)> run;
+
+    // Workloads far slower than the rest run operations / divisor.
+    std::size_t divisor = 1;
+};
+
+
+struct result final {
+    double throughput;
+    double allocations;
+    double locales;
+};
+
+
+constexpr const char* kVersionPattern =
+    "^(0|[1-9]\\d*)\\.(0|[1-9]\\d*)\\.(0|[1-9]\\d*)(?:-([0-9A-Za-z.-]+))?(?:\\+([0-9A-Za-z.-]+))?$";
+
+
+const workload kWorkloads[] = {
+    { "version::parse", false, [](const inputs& in, std::size_t offset, std::size_t operations) {
+        std::uint64_t sink = 0;
+        for (std::size_t index = 0; index < operations; ++index)
+            sink += sk::version<>::parse(in.texts[(offset + index) % in.texts.size()]).patch();
+        return sink;
+    } },
+    { "static_version::parse", false, [](const inputs& in, std::size_t offset, std::size_t operations) {
+        std::uint64_t sink = 0;
+        for (std::size_t index = 0; index < operations; ++index)
+            sink += sk::static_version<32>::parse(in.texts[(offset + index) % in.texts.size()]).patch();
+        return sink;
+    } },
+    { "version::compare", false, [](const inputs& in, std::size_t offset, std::size_t operations) {
+        std::uint64_t sink = 0;
+        const auto size = in.versions.size();
+        for (std::size_t index = 0; index < operations; ++index)
+            sink += in.versions[(offset + index) % size] < in.versions[(offset + index * 7 + 1) % size];
+        return sink;
+    } },
+    { "static_version::compare", false, [](const inputs& in, std::size_t offset, std::size_t operations) {
+        std::uint64_t sink = 0;
+        const auto size = in.statics.size();
+        for (std::size_t index = 0; index < operations; ++index)
+            sink += in.statics[(offset + index) % size] < in.statics[(offset + index * 7 + 1) % size];
+        return sink;
+    } },
+    { "version format", false, [](const inputs& in, std::size_t offset, std::size_t operations) {
+        std::uint64_t sink = 0;
+        for (std::size_t index = 0; index < operations; ++index) {
+            const auto& from = in.statics[(offset + index) % in.statics.size()];
+            sink += sk::version<>{ from.major(), from.minor(), from.patch(),
+                                   from.pre(), from.build() }.str().size();
+        }
+        return sink;
+    } },
+    // Compiled per operation, as a validator written against std::regex
+    // usually is. The regex traits hold a copy of the global locale.
+    { "std::regex", true, [](const inputs& in, std::size_t offset, std::size_t operations) {
+        std::uint64_t sink = 0;
+        for (std::size_t index = 0; index < operations; ++index) {
+            const std::regex pattern{ kVersionPattern };
+            ++tLocales;
+            sink += std::regex_match(in.texts[(offset + index) % in.texts.size()], pattern);
+        }
+        return sink;
+    }, 100 },
+    // The stream's ios_base holds a copy of the global locale.
+    { "std::ostringstream", true, [](const inputs& in, std::size_t offset, std::size_t operations) {
+        std::uint64_t sink = 0;
+        for (std::size_t index = 0; index < operations; ++index) {
+            const auto& from = in.statics[(offset + index) % in.statics.size()];
+            std::ostringstream out;
+            ++tLocales;
+            out << from.major() << '.' << from.minor() << '.' << from.patch();
+            sink += out.str().size();
+        }
+        return sink;
+    } },
+};
+
+
+// Nothing but a copy of the global locale per operation.
+const workload kLocaleProbe{ "std::locale", true, [](const inputs&, std::size_t, std::size_t operations) {
+    std::uint64_t sink = 0;
+    for (std::size_t index = 0; index < operations; ++index) {
+        const std::locale locale;
+        ++tLocales;
+        sink += std::has_facet<std::ctype<char>>(locale);
+    }
+    return sink;
+} };
+
+
+result
+measure(const workload& work, const inputs& in, std::size_t threads, std::size_t operations) {
+    using clock = std::chrono::steady_clock;
+
+    operations = std::max<std::size_t>(operations / work.divisor, 1);
+    // Workers check in, then all start together once the clock is running.
+    std::latch ready{ static_cast<std::ptrdiff_t>(threads) };
+    std::latch start{ 1 };
+    std::atomic<std::uint64_t> allocations{ 0 };
+    std::atomic<std::uint64_t> locales{ 0 };
+    std::atomic<std::uint64_t> sink{ 0 };
+
+    std::vector<std::thread> pool;
+    for (std::size_t thread = 0; thread < threads; ++thread) {
+        pool.emplace_back([&, thread] {
+            ready.count_down();
+            start.wait();
+            const auto allocationsBefore = tAllocations;
+            const auto localesBefore     = tLocales;
+            sink += work.run(in, thread * 7919, operations);
+            allocations += tAllocations - allocationsBefore;
+            locales     += tLocales - localesBefore;
+        });
+    }
+
+    ready.wait();
+    const auto began = clock::now();
+    start.count_down();
+    for (auto& thread : pool)
+        thread.join();
+
+    const auto seconds = std::chrono::duration<double>(clock::now() - began).count();
+    const auto total   = static_cast<double>(threads * operations);
+    if (sink.load() == std::uint64_t(-1))
+        std::puts("");
+
+    return { total / seconds,
+             static_cast<double>(allocations.load()) / total,
+             static_cast<double>(locales.load()) / total };
+}
+
+
+// Names the shared state the measurements point at, once efficiency at the
+// highest thread count with a core of its own has dropped.
+std::string
+attribute(const result& measured, bool localeContended) {
+    std::string causes;
+    if (measured.allocations >= 0.1)
+        causes = "heap allocations";
+    if (measured.locales > 0.0 && localeContended)
+        causes.append(causes.empty() ? "" : " and ").append("global locale copies");
+
+    if (causes.empty())
+        return "contended without allocations or locale copies: "
+               "check false sharing or memory bandwidth";
+    return "contended, shared state is " + causes;
+}
+
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    // Parsed signed so that negative counts are rejected, not wrapped.
+    long long threadArg    = std::max(1u, std::thread::hardware_concurrency());
+    long long operationArg = 200000;
+    try {
+        if (argc > 1) threadArg    = std::stoll(argv[1]);
+        if (argc > 2) operationArg = std::stoll(argv[2]);
+    } catch (const std::exception&) {
+        threadArg = 0;
+    }
+
+    if (argc > 3 || threadArg < 1 || operationArg < 1) {
+        std::fprintf(stderr, "usage: %s [max threads >= 1] [operations per thread >= 1]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const auto maxThreads = static_cast<std::size_t>(threadArg);
+    const auto operations = static_cast<std::size_t>(operationArg);
+
+    sk::bench::registry_options options;
+    options.packages = 2000;
+    const auto registry = sk::bench::generate(options);
+
+    inputs in;
+    for (const auto& release : registry.releases) {
+        in.texts.push_back(release.version);
+        in.versions.push_back(sk::version<>::parse(release.version));
+        in.statics.push_back(sk::static_version<32>::parse(release.version));
+    }
+
+    const std::size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    if (maxThreads > cores)
+        std::printf("note: %zu threads on %zu cores, efficiency past %zu threads "
+                    "measures oversubscription, not contention\n", maxThreads, cores, cores);
+
+    std::vector<std::size_t> counts;
+    for (std::size_t threads = 1; threads < maxThreads; threads *= 2)
+        counts.push_back(threads);
+    counts.push_back(maxThreads);
+
+    // Whether copying the global locale contends here, measured once at the
+    // thread count the verdicts are judged at.
+    const auto probeThreads     = std::min(maxThreads, cores);
+    const auto probeBaseline    = measure(kLocaleProbe, in, 1, operations).throughput;
+    const auto probeScaled      = measure(kLocaleProbe, in, probeThreads, operations).throughput;
+    const auto localeEfficiency = probeScaled / probeBaseline / static_cast<double>(probeThreads);
+    const bool localeContended  = probeThreads > 1 && localeEfficiency < 0.7;
+
+    std::printf("%zu inputs, %zu operations per thread\n", in.texts.size(), operations);
+    if (probeThreads > 1)
+        std::printf("std::locale copies scale at %.2f efficiency on %zu threads\n",
+                    localeEfficiency, probeThreads);
+
+    std::printf("\n%-24s %8s %12s %9s %11s %10s %11s\n",
+                "workload", "threads", "kops/s", "speedup", "efficiency", "allocs/op", "locales/op");
+    for (const auto& work : kWorkloads) {
+        double      baseline   = 0.0;
+        double      efficiency = 1.0;
+        result      judgedAt   = {};
+        std::size_t judged     = 1;
+        for (auto threads : counts) {
+            const auto measured = measure(work, in, threads, operations);
+            if (threads == 1) baseline = measured.throughput;
+
+            const auto speedup = measured.throughput / baseline;
+            const auto scaled  = speedup / static_cast<double>(threads);
+            if (threads <= cores) {
+                efficiency = scaled;
+                judgedAt   = measured;
+                judged     = threads;
+            }
+
+            std::printf("%-24s %8zu %12.1f %9.2f %11.2f %10.2f %11.2f\n",
+                        work.name, threads, measured.throughput / 1e3,
+                        speedup, scaled, measured.allocations, measured.locales);
+        }
+
+        // Flag what most likely limits scaling at the highest thread count
+        // that still has a core of its own.
+        std::string verdict = "scales";
+        if (judged == 1)
+            verdict = "not measured, a single core is available";
+        else if (efficiency < 0.7)
+            verdict = attribute(judgedAt, localeContended);
+        std::printf("%-24s %s\n\n", work.control ? "  control" : "  verdict", verdict.c_str());
+    }
+
+    return EXIT_SUCCESS;
+}
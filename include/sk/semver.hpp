@@ -1,10 +1,23 @@
 #ifndef SK_SEMVER_HPP
 #define SK_SEMVER_HPP
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <functional>
 #include <cstdint>
-#include <regex>
+#include <limits>
 #include <stdexcept>
-#include <sstream>
+#include <string>
 #include <string_view>
+#include <utility>
+
+#ifdef SK_SEMVER_HISTOGRAMS
+#   include "sk/semver/histogram.hpp"
+#   define SK_SEMVER_TIME_SCOPE(op) \
+        ::sk::histograms::scoped_timer skSemverScopedTimer{ ::sk::histograms::metric::op }
+#else
+#   define SK_SEMVER_TIME_SCOPE(op)
+#endif
 
 
 namespace sk {
@@ -13,19 +26,73 @@ namespace sk {
 // Forward declarations.
 template<typename Policy>
 class version;
+template<std::size_t Capacity, typename Policy>
+class static_version;
 class prerelease;
 class build_meta;
 
 
+// Upper bounds enforced while parsing. Input is rejected as soon as a bound is
+// exceeded, so the work done per string never exceeds these lengths.
+struct parse_limits final {
+    std::size_t max_length            = 256;
+    std::size_t max_numeric_length    = 20;
+    std::size_t max_prerelease_length = 128;
+    std::size_t max_build_length      = 128;
+    std::size_t max_identifiers       = 32;
+};
+
+
+enum class parse_error : std::uint8_t {
+    none,
+    empty,
+    too_long,
+    missing_major,
+    missing_minor,
+    missing_patch,
+    leading_zero,
+    numeric_too_long,
+    numeric_overflow,
+    empty_identifier,
+    too_many_identifiers,
+    prerelease_too_long,
+    build_too_long,
+    invalid_character,
+};
+
+
+constexpr const char*
+describe(parse_error error) noexcept {
+    switch (error) {
+    case parse_error::none:                 return "No error";
+    case parse_error::empty:                return "Empty version string";
+    case parse_error::too_long:             return "Version string is too long";
+    case parse_error::missing_major:        return "Major version is required";
+    case parse_error::missing_minor:        return "Minor version is required";
+    case parse_error::missing_patch:        return "Patch version is required";
+    case parse_error::leading_zero:         return "Leading zero in numeric identifier";
+    case parse_error::numeric_too_long:     return "Numeric identifier is too long";
+    case parse_error::numeric_overflow:     return "Numeric identifier is out of range";
+    case parse_error::empty_identifier:     return "Empty identifier";
+    case parse_error::too_many_identifiers: return "Too many identifiers";
+    case parse_error::prerelease_too_long:  return "Prerelease is too long";
+    case parse_error::build_too_long:       return "Build meta is too long";
+    case parse_error::invalid_character:    return "Invalid character in version string";
+    }
+
+    return "Unknown error";
+}
+
+
 namespace detail {
 
 
 template<typename Policy>
-class has_kPattern_var {
+class has_kAllowPrefix_var {
 private:
     template<typename T>
     static auto test(int) ->
-        decltype(T::kPattern, std::true_type());
+        decltype(bool{ T::kAllowPrefix }, std::true_type());
 
     template<typename>
     static auto test(...) ->
@@ -38,11 +105,11 @@ public:
 
 
 template<typename Policy>
-class has_validateSchema_fn {
+class has_kAllowPartial_var {
 private:
     template<typename T>
     static auto test(int) ->
-        decltype(T::validateSchema(std::declval<const std::cmatch&>()), std::true_type());
+        decltype(bool{ T::kAllowPartial }, std::true_type());
 
     template<typename>
     static auto test(...) ->
@@ -55,20 +122,43 @@ public:
 
 
 template<typename Policy>
-inline constexpr bool has_validateSchema_fn_v =
-    has_validateSchema_fn<Policy>::value;
+class has_kLimits_var {
+private:
+    template<typename T>
+    static auto test(int) ->
+        decltype(parse_limits{ T::kLimits }, std::true_type());
+
+    template<typename>
+    static auto test(...) ->
+        std::false_type;
+
+public:
+    constexpr static bool
+    value = decltype(test<Policy>(0))::value;
+};
+
+
+template<typename Policy>
+inline constexpr bool has_kAllowPrefix_var_v =
+    has_kAllowPrefix_var<Policy>::value;
+
+
+template<typename Policy>
+inline constexpr bool has_kAllowPartial_var_v =
+    has_kAllowPartial_var<Policy>::value;
 
 
 template<typename Policy>
-inline constexpr bool has_kPattern_var_v =
-    has_kPattern_var<Policy>::value;
+inline constexpr bool has_kLimits_var_v =
+    has_kLimits_var<Policy>::value;
 
 
 template<typename Policy>
 struct is_parsing_policy {
     constexpr static bool
-    value = has_kPattern_var_v<Policy> &&
-            has_validateSchema_fn_v<Policy>;
+    value = has_kAllowPrefix_var_v<Policy> &&
+            has_kAllowPartial_var_v<Policy> &&
+            has_kLimits_var_v<Policy>;
 };
 
 
@@ -79,222 +169,458 @@ inline constexpr bool is_parsing_policy_v =
 
 
 struct strict_version_parsing_policy final {
-    constexpr static std::string_view
-    kPattern = "^(0|[1-9]\\d*)\\.(0|[1-9]\\d*)\\.(0|[1-9]\\d*)"
-               "(?:-((?:0|[1-9]\\d*|\\d*[a-zA-Z-][0-9a-zA-Z-]*)(?:\\.(?:0|[1-9]\\d*|\\d*[a-zA-Z-][0-9a-zA-Z-]*))*))"
-               "?(?:\\+([0-9a-zA-Z-]+(?:\\.[0-9a-zA-Z-]+)*))?$";
-
-    static void
-    validateSchema(const std::cmatch& match) {
-        constexpr std::string_view kMajorRequired = "Major version is required";
-        constexpr std::string_view kMinorRequired = "Minor version is required";
-        constexpr std::string_view kPatchRequired = "Patch version is required";
-
-        // The first three parts are required.
-        if (!match[1].matched) throw std::invalid_argument(kMajorRequired.data());
-        if (!match[2].matched) throw std::invalid_argument(kMajorRequired.data());
-        if (!match[3].matched) throw std::invalid_argument(kPatchRequired.data());
-    }
+    // Major, minor and patch are all required, no leading 'v'.
+    constexpr static bool kAllowPrefix  = false;
+    constexpr static bool kAllowPartial = false;
+
+    constexpr static parse_limits kLimits = {};
 };
 
 
 
 struct loose_version_parsing_policy final {
-    constexpr static std::string_view
-    kPattern = "^v?(0|[1-9]\\d*)(?:\\.(0|[1-9]\\d*))?(?:\\.(0|[1-9]\\d*))"
-               "?(?:-((?:0|[1-9]\\d*|\\d*[a-zA-Z-][0-9a-zA-Z-]*)(?:\\.(?:0|[1-9]\\d*|\\d*[a-zA-Z-][0-9a-zA-Z-]*))*))"
-               "?(?:\\+([0-9a-zA-Z-]+(?:\\.[0-9a-zA-Z-]+)*))?$";
+    // Accepts "v1", "1.2" and the like, missing parts default to zero.
+    constexpr static bool kAllowPrefix  = true;
+    constexpr static bool kAllowPartial = true;
 
-    static void
-    validateSchema(const std::cmatch& match) {
-        // Only need to validate the the major version is present.
-        constexpr std::string_view kMajorRequired = "Major version is required";
-        if (!match[1].matched) throw std::invalid_argument(kMajorRequired.data());
-    }
+    constexpr static parse_limits kLimits = {};
 };
 
 
 
-inline std::uint64_t
-convertNumeric(std::string_view number,
-               std::string_view partName) {
-    try {
-        return std::stoull(number.data());
-    } catch (const std::exception&) {
-        throw std::invalid_argument(partName.data());
-    }
+// Offsets of the textual parts of a version within the scanned string.
+struct version_fields final {
+    std::uint64_t major = 0;
+    std::uint64_t minor = 0;
+    std::uint64_t patch = 0;
+
+    std::size_t prerelease_offset = 0;
+    std::size_t prerelease_length = 0;
+    std::size_t build_offset      = 0;
+    std::size_t build_length      = 0;
+
+    // Whether the scanned text is already in normal form, i.e. it had no
+    // prefix and spelled out all three numeric parts.
+    bool canonical = true;
+};
+
+
+constexpr bool
+isDigit(char c) noexcept {
+    return c >= '0' && c <= '9';
 }
 
 
-} // namespace sk::detail
+// Deliberately not std::isalnum, which consults the global locale.
+constexpr bool
+isIdentifierChar(char c) noexcept {
+    return isDigit(c)
+        || (c >= 'a' && c <= 'z')
+        || (c >= 'A' && c <= 'Z')
+        || c == '-';
+}
 
 
-class prerelease final {
-    class part final {
-    public:
-        constexpr part() = default;
-                 ~part() = default;
+constexpr parse_error
+scanNumeric(std::string_view text,
+            std::size_t&     position,
+            std::uint64_t&   value,
+            std::size_t      maxLength,
+            parse_error      missing) noexcept {
+    constexpr auto kMax = std::numeric_limits<std::uint64_t>::max();
 
-        constexpr part(std::string_view value) noexcept
-            : value_(value) {}
+    const auto start = position;
+    value = 0;
+    while (position < text.size() && isDigit(text[position])) {
+        if (position - start == maxLength)
+            return parse_error::numeric_too_long;
 
-        constexpr part(const part&) = default;
-        constexpr part& operator=(const part&) = default;
+        const auto digit = static_cast<std::uint64_t>(text[position] - '0');
+        if (value > (kMax - digit) / 10)
+            return parse_error::numeric_overflow;
 
-        constexpr part(part&&) noexcept = default;
-        constexpr part& operator=(part&&) noexcept = default;
+        value = value * 10 + digit;
+        ++position;
+    }
 
-        constexpr static part
-        parse(std::string_view text) {
-            auto is_valid = std::all_of(text.begin(), text.end(), [](char c) {
-                return std::isalnum(c) || c == '-';
-            });
+    if (position == start)
+        return missing;
 
-            if (text.empty() || !is_valid)
-                throw std::invalid_argument("Empty prerelease part.");
+    if (text[start] == '0' && position - start > 1)
+        return parse_error::leading_zero;
 
-            if (text.size() > 1 && text[0] == '0')
-                throw std::invalid_argument("Leading zero in prerelease part.");
+    return parse_error::none;
+}
 
-            return part{ text };
-        }
 
-    #ifdef __cpp_impl_three_way_comparison
-        constexpr std::strong_ordering
-        operator<=>(const part& other) const noexcept {
-            return value_ <=> other.value_;
-        }
-    #else
-        constexpr bool
-        operator==(const part& other) const noexcept {
-            return value_ == other.value_;
+// Scans a dot separated identifier list. Prerelease identifiers that are
+// numeric may not have leading zeros, build identifiers may.
+constexpr parse_error
+scanIdentifiers(std::string_view text,
+                std::size_t&     position,
+                bool             prerelease,
+                std::size_t      maxLength,
+                std::size_t      maxIdentifiers) noexcept {
+    const auto start = position;
+    std::size_t count = 0;
+    while (true) {
+        const auto identifier = position;
+        bool numeric = true;
+        while (position < text.size() && isIdentifierChar(text[position])) {
+            numeric = numeric && isDigit(text[position]);
+            ++position;
         }
 
-        constexpr bool
-        operator!=(const part& other) const noexcept {
-            return value_ != other.value_;
-        }
+        if (position == identifier)
+            return parse_error::empty_identifier;
 
-        constexpr bool
-        operator<(const part& other) const noexcept {
-            return value_ < other.value_;
-        }
+        if (prerelease && numeric && text[identifier] == '0' && position - identifier > 1)
+            return parse_error::leading_zero;
 
-        constexpr bool
-        operator>(const part& other) const noexcept {
-            return value_ > other.value_;
-        }
+        if (++count > maxIdentifiers)
+            return parse_error::too_many_identifiers;
 
-        constexpr bool
-        operator<=(const part& other) const noexcept {
-            return value_ <= other.value_;
-        }
+        if (position - start > maxLength)
+            return prerelease ? parse_error::prerelease_too_long
+                              : parse_error::build_too_long;
 
-        constexpr bool
-        operator>=(const part& other) const noexcept {
-            return value_ >= other.value_;
+        if (position == text.size() || text[position] != '.')
+            return parse_error::none;
+
+        ++position;
+    }
+}
+
+
+// Single forward pass over the text without recursion or backtracking, so
+// the cost is linear in the input and bounded by the policy's limits.
+template<typename Policy>
+constexpr parse_error
+scanVersion(std::string_view text, version_fields& fields) noexcept {
+    constexpr parse_limits kLimits = Policy::kLimits;
+
+    if (text.empty()) return parse_error::empty;
+    if (text.size() > kLimits.max_length) return parse_error::too_long;
+
+    std::size_t position = 0;
+    if (Policy::kAllowPrefix && text[0] == 'v') {
+        fields.canonical = false;
+        ++position;
+    }
+
+    auto error = scanNumeric(text, position, fields.major,
+                             kLimits.max_numeric_length,
+                             parse_error::missing_major);
+    if (error != parse_error::none) return error;
+
+    std::uint64_t* const rest[] = { &fields.minor, &fields.patch };
+    const parse_error missing[] = { parse_error::missing_minor,
+                                    parse_error::missing_patch };
+    for (std::size_t index = 0; index < 2; ++index) {
+        if (position < text.size() && text[position] == '.') {
+            ++position;
+            error = scanNumeric(text, position, *rest[index],
+                                kLimits.max_numeric_length,
+                                missing[index]);
+            if (error != parse_error::none) return error;
+        } else if (Policy::kAllowPartial) {
+            fields.canonical = false;
+            break;
+        } else {
+            return missing[index];
         }
-    #endif
+    }
+
+    if (position < text.size() && text[position] == '-') {
+        fields.prerelease_offset = ++position;
+        error = scanIdentifiers(text, position, true,
+                                kLimits.max_prerelease_length,
+                                kLimits.max_identifiers);
+        if (error != parse_error::none) return error;
+        fields.prerelease_length = position - fields.prerelease_offset;
+    }
+
+    if (position < text.size() && text[position] == '+') {
+        fields.build_offset = ++position;
+        error = scanIdentifiers(text, position, false,
+                                kLimits.max_build_length,
+                                kLimits.max_identifiers);
+        if (error != parse_error::none) return error;
+        fields.build_length = position - fields.build_offset;
+    }
+
+    return position == text.size()
+        ? parse_error::none
+        : parse_error::invalid_character;
+}
+
 
-    private:
-        std::string_view value_;
-    };
+// Checks text given as a prerelease or build meta outside of a full version
+// string, e.g. through the unchecked identifier view constructors.
+constexpr void
+validateIdentifiers(std::string_view text, bool prerelease) {
+    constexpr auto kUnbounded = std::string_view::npos;
 
+    if (text.empty())
+        return;
+
+    std::size_t position = 0;
+    const auto error = scanIdentifiers(text, position, prerelease,
+                                       kUnbounded, kUnbounded);
+    if (error != parse_error::none)
+        throw std::invalid_argument(describe(error));
+
+    if (position != text.size())
+        throw std::invalid_argument(describe(parse_error::invalid_character));
+}
+
+
+// Compares a single prerelease identifier, numeric identifiers compare by
+// value and sort before alphanumeric ones.
+constexpr int
+compareIdentifier(std::string_view lhs, std::string_view rhs) noexcept {
+    const bool lhsNumeric = std::all_of(lhs.begin(), lhs.end(), isDigit);
+    const bool rhsNumeric = std::all_of(rhs.begin(), rhs.end(), isDigit);
+    if (lhsNumeric != rhsNumeric)
+        return lhsNumeric ? -1 : 1;
+
+    // No leading zeros, so the longer number is the larger one.
+    if (lhsNumeric && lhs.size() != rhs.size())
+        return lhs.size() < rhs.size() ? -1 : 1;
+
+    const int result = lhs.compare(rhs);
+    return result == 0 ? 0 : (result < 0 ? -1 : 1);
+}
+
+
+// Compares two dot separated prerelease identifier lists by semver rules
+// without splitting them up front.
+constexpr int
+compareIdentifiers(std::string_view lhs, std::string_view rhs) noexcept {
+    std::size_t lhsPos = 0;
+    std::size_t rhsPos = 0;
+    while (lhsPos < lhs.size() && rhsPos < rhs.size()) {
+        auto lhsEnd = lhs.find('.', lhsPos);
+        auto rhsEnd = rhs.find('.', rhsPos);
+        if (lhsEnd == std::string_view::npos) lhsEnd = lhs.size();
+        if (rhsEnd == std::string_view::npos) rhsEnd = rhs.size();
+
+        const int result = compareIdentifier(lhs.substr(lhsPos, lhsEnd - lhsPos),
+                                             rhs.substr(rhsPos, rhsEnd - rhsPos));
+        if (result != 0) return result;
+        lhsPos = lhsEnd + 1;
+        rhsPos = rhsEnd + 1;
+    }
+
+    const bool lhsDone = lhsPos >= lhs.size();
+    const bool rhsDone = rhsPos >= rhs.size();
+    if (lhsDone == rhsDone) return 0;
+    return lhsDone ? -1 : 1;
+}
+
+
+// splitmix64 finaliser, spreads every input bit over the whole word.
+constexpr std::uint64_t
+mix64(std::uint64_t value) noexcept {
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ull;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebull;
+    return value ^ (value >> 31);
+}
+
+
+constexpr std::uint64_t
+fnv1a(std::string_view text) noexcept {
+    std::uint64_t result = 0xcbf29ce484222325ull;
+    for (char c : text) {
+        result ^= static_cast<unsigned char>(c);
+        result *= 0x100000001b3ull;
+    }
+
+    return result;
+}
+
+
+// Hash over everything that takes part in precedence, so versions that
+// compare equal hash equally. Well mixed enough to feed sketches directly.
+constexpr std::uint64_t
+hashVersion(std::uint64_t major,
+            std::uint64_t minor,
+            std::uint64_t patch,
+            std::string_view prerelease) noexcept {
+    std::uint64_t result = mix64(major);
+    result = mix64(result ^ minor);
+    result = mix64(result ^ patch);
+    return mix64(result ^ fnv1a(prerelease));
+}
+
+
+inline void
+appendNumeric(std::string& out, std::uint64_t value) {
+    char buffer[20];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+
+} // namespace sk::detail
+
+
+// View over dot separated prerelease identifiers, e.g. "rc.1". It holds no
+// storage of its own, so it is usable in constant expressions and a table
+// of them over string literals lands in read-only data. The viewed text
+// must outlive it.
+class prerelease final {
 public:
     constexpr prerelease() = default;
              ~prerelease() = default;
 
-    constexpr prerelease(std::string_view value,
-                         std::vector<part> parts) noexcept
-        : value_(value)
-        , parts_(std::move(parts)) {}
+    constexpr explicit prerelease(std::string_view value) noexcept
+        : value_(value) {}
 
-    constexpr prerelease(std::string_view value,
-                         std::vector<std::string_view> parts) noexcept
-        : value_(value) {
-        for (auto substr : parts)
-            parts_.emplace_back(part::parse(substr));
-    }
-    
     constexpr prerelease(const prerelease&) = default;
     constexpr prerelease(prerelease&&) noexcept = default;
     constexpr prerelease& operator=(const prerelease&) = default;
     constexpr prerelease& operator=(prerelease&&) noexcept = default;
 
+    constexpr static prerelease
+    parse(std::string_view text) {
+        constexpr auto kUnbounded = std::string_view::npos;
+
+        if (text.empty())
+            return prerelease{};
+
+        std::size_t position = 0;
+        const auto error = detail::scanIdentifiers(text, position, true,
+                                                   kUnbounded, kUnbounded);
+        if (error != parse_error::none)
+            throw std::invalid_argument(describe(error));
+
+        if (position != text.size())
+            throw std::invalid_argument(describe(parse_error::invalid_character));
+
+        return prerelease{ text };
+    }
+
+    constexpr bool
+    empty() const noexcept {
+        return value_.empty();
+    }
+
+    constexpr std::string_view
+    str() const noexcept {
+        return value_;
+    }
+
+    // Compares identifier by identifier, a shorter list of otherwise equal
+    // identifiers has lower precedence.
+    constexpr int
+    compare(const prerelease& other) const noexcept {
+        return detail::compareIdentifiers(value_, other.value_);
+    }
+
     #ifdef __cpp_impl_three_way_comparison
         constexpr std::weak_ordering
         operator<=>(const prerelease& other) const noexcept {
-            return parts_ <=> other.parts_;
+            return compare(other) <=> 0;
+        }
+
+        constexpr bool
+        operator==(const prerelease& other) const noexcept {
+            return compare(other) == 0;
         }
     #else
+        constexpr bool
+        operator==(const prerelease& other) const noexcept {
+            return compare(other) == 0;
+        }
 
-    #endif
+        constexpr bool
+        operator!=(const prerelease& other) const noexcept {
+            return compare(other) != 0;
+        }
 
-    // TODO: attempt to make constexpr.
-    static prerelease
-    parse(std::string_view str) {
-        if (str.empty())
-            return prerelease{};
+        constexpr bool
+        operator<(const prerelease& other) const noexcept {
+            return compare(other) < 0;
+        }
 
-        std::vector<part> parts;
-        for (auto substr : split(str))
-            parts.emplace_back(part::parse(substr));
-        return prerelease{ str, parts };
-    }
+        constexpr bool
+        operator>(const prerelease& other) const noexcept {
+            return compare(other) > 0;
+        }
 
-private:
-    static std::vector<std::string_view>
-    split(std::string_view str) {
-        constexpr char kDelimiter = '.';
-
-        std::size_t current  = 0;
-        std::size_t previous = 0;
-        std::vector<std::string_view> result;
-        
-        current = str.find(kDelimiter);
-        while (current != std::string_view::npos) {
-            result.emplace_back(str.substr(previous, current - previous));
-            previous = current + 1;
-            current  = str.find(kDelimiter, previous);
+        constexpr bool
+        operator<=(const prerelease& other) const noexcept {
+            return compare(other) <= 0;
         }
 
-        result.emplace_back(str.substr(previous, current - previous));
-        return result;
-    }
+        constexpr bool
+        operator>=(const prerelease& other) const noexcept {
+            return compare(other) >= 0;
+        }
+    #endif
 
 private:
-    std::vector<part> parts_;
-    std::string_view  value_;
+    std::string_view value_;
 };
 
 
 
+// View over dot separated build identifiers, e.g. "build.5". Like prerelease
+// it is usable in constant expressions and the viewed text must outlive it.
 class build_meta final {
 public:
-    build_meta() = default;
-    ~build_meta() = default;
+    constexpr build_meta() = default;
+             ~build_meta() = default;
 
-    build_meta(std::string_view value) noexcept
+    constexpr build_meta(std::string_view value) noexcept
         : value_(value) {}
 
-    build_meta(const build_meta&) = default;
-    build_meta& operator=(const build_meta&) = default;
+    constexpr build_meta(const build_meta&) = default;
+    constexpr build_meta& operator=(const build_meta&) = default;
 
-    build_meta(build_meta&&) noexcept = default;
-    build_meta& operator=(build_meta&&) noexcept = default;
+    constexpr build_meta(build_meta&&) noexcept = default;
+    constexpr build_meta& operator=(build_meta&&) noexcept = default;
 
-    static build_meta
+    constexpr static build_meta
     parse(std::string_view text) {
-        auto is_valid = std::all_of(text.begin(), text.end(), [](char c) {
-                return std::isalnum(c) || c == '-';
-            });
+        constexpr auto kUnbounded = std::string_view::npos;
+
+        std::size_t position = 0;
+        const auto error = detail::scanIdentifiers(text, position, false,
+                                                   kUnbounded, kUnbounded);
+        if (error != parse_error::none)
+            throw std::invalid_argument(describe(error));
 
-        if (text.empty() || !is_valid)
-            throw std::invalid_argument("Empty build meta.");
+        if (position != text.size())
+            throw std::invalid_argument(describe(parse_error::invalid_character));
 
         return build_meta{ text };
     }
 
+    constexpr bool
+    empty() const noexcept {
+        return value_.empty();
+    }
+
+    constexpr std::string_view
+    str() const noexcept {
+        return value_;
+    }
+
+    // Build meta has no precedence, only equality.
+    constexpr bool
+    operator==(const build_meta& other) const noexcept {
+        return value_ == other.value_;
+    }
+
+    constexpr bool
+    operator!=(const build_meta& other) const noexcept {
+        return value_ != other.value_;
+    }
+
 private:
     std::string_view value_;
 };
@@ -303,85 +629,485 @@ private:
 
 template<typename Policy = detail::strict_version_parsing_policy>
 class version final {
-    constexpr static std::string_view kPolicyError =
-        "Policy must implement a static parse(const std::string&) function.";
-
-    // Verify that the policy implements a static parse(const std::string&) function.
-    static_assert(detail::is_parsing_policy_v<Policy>, kPolicyError.data());
+    // Verify that the policy provides the flags and limits the scanner needs.
+    static_assert(detail::is_parsing_policy_v<Policy>,
+                  "Policy must provide kAllowPrefix, kAllowPartial and kLimits.");
 
 public:
     version() = default;
     ~version() = default;
 
     version(const version&) = default;
-    version(version&&) noexcept = default;
     version& operator=(const version&) = default;
-    version& operator=(version&&) noexcept = default;
+
+    // The source is left as the default version, its lengths must never
+    // describe text it no longer owns.
+    version(version&& other) noexcept
+        : value_(std::exchange(other.value_, "0.0.0"))
+        , major_(std::exchange(other.major_, 0))
+        , minor_(std::exchange(other.minor_, 0))
+        , patch_(std::exchange(other.patch_, 0))
+        , prerelease_length_(std::exchange(other.prerelease_length_, 0))
+        , build_length_(std::exchange(other.build_length_, 0)) {}
+
+    version&
+    operator=(version&& other) noexcept {
+        if (this != &other) {
+            value_             = std::exchange(other.value_, "0.0.0");
+            major_             = std::exchange(other.major_, 0);
+            minor_             = std::exchange(other.minor_, 0);
+            patch_             = std::exchange(other.patch_, 0);
+            prerelease_length_ = std::exchange(other.prerelease_length_, 0);
+            build_length_      = std::exchange(other.build_length_, 0);
+        }
+
+        return *this;
+    }
 
     version(std::uint64_t major,
             std::uint64_t minor,
             std::uint64_t patch,
-            prerelease prerelease = prerelease{},
-            build_meta build_meta = build_meta{}) noexcept
-        : prerelease_(std::move(prerelease))
-        , build_meta_(std::move(build_meta))
-        , major_(major)
+            const prerelease& prerel = prerelease{},
+            const build_meta& meta   = build_meta{})
+        : major_(major)
         , minor_(minor)
-        , patch_(patch) {}
+        , patch_(patch) {
+        assign(prerel.str(), meta.str());
+    }
 
 
+    // Runs in time linear in the input and never more than the policy's
+    // limits, regardless of how hostile the input is.
     static version
-    parse(const std::string& str) {
-        auto regex = std::regex(Policy::kPattern.data());
-
-        std::cmatch match;
-        if (!std::regex_match(input.data(), match, regex))
-            throw std::invalid_argument("invalid version string");
-
-        std::uint64_t major = 0;
-        std::uint64_t minor = 0;
-        std::uint64_t patch = 0;
-        prerelease    prerel;
-        build_meta    meta;
-        try {
-            Policy::validateSchema(match);
-            major = convertNumeric(match[1].str(), "major");
-            minor = match[2].matched
-                ? convertNumeric(match[2].str(), "minor")
-                : 0;
-            patch = match[3].matched
-                ? convertNumeric(match[3].str(), "patch")
-                : 0;
-
-            if (match[4].matched) prerel = prerelease::parse(match[4].str());
-            if (match[5].matched) meta   = build_meta::parse(match[5].str());
-        } catch (const std::exception& e) {
-            constexpr std::string_view kErrorMessage =
-                "Failed to parse version string: ";
-            
-            std::ostringstream out;
-            out << kErrorMessage
-                << e.what();
-            
-            throw std::invalid_argument(out.str());
+    parse(std::string_view text) {
+        constexpr std::string_view kErrorMessage =
+            "Failed to parse version string: ";
+
+        SK_SEMVER_TIME_SCOPE(parse);
+        detail::version_fields fields;
+        const auto error = detail::scanVersion<Policy>(text, fields);
+        if (error != parse_error::none)
+            throw std::invalid_argument(std::string{ kErrorMessage } + describe(error));
+
+        version result;
+        result.major_ = fields.major;
+        result.minor_ = fields.minor;
+        result.patch_ = fields.patch;
+        if (!fields.canonical) {
+            result.store(text.substr(fields.prerelease_offset, fields.prerelease_length),
+                          text.substr(fields.build_offset, fields.build_length));
+            return result;
+        }
+
+        result.value_.assign(text);
+        result.prerelease_length_ = fields.prerelease_length;
+        result.build_length_      = fields.build_length;
+        return result;
+    }
+
+    std::uint64_t
+    major() const noexcept {
+        return major_;
+    }
+
+    std::uint64_t
+    minor() const noexcept {
+        return minor_;
+    }
+
+    std::uint64_t
+    patch() const noexcept {
+        return patch_;
+    }
+
+    prerelease
+    pre() const noexcept {
+        return prerelease{ prereleaseText() };
+    }
+
+    build_meta
+    build() const noexcept {
+        return build_meta{ buildText() };
+    }
+
+    // Consistent with compare(), build metadata does not contribute.
+    std::uint64_t
+    hash() const noexcept {
+        return detail::hashVersion(major_, minor_, patch_, prereleaseText());
+    }
+
+    // The version in normal form, e.g. "1.2.3-rc.1+build.5".
+    const std::string&
+    str() const noexcept {
+        return value_;
+    }
+
+    // Precedence as defined by semver 2.0.0, build metadata is ignored.
+    int
+    compare(const version& other) const noexcept {
+        if (major_ != other.major_) return major_ < other.major_ ? -1 : 1;
+        if (minor_ != other.minor_) return minor_ < other.minor_ ? -1 : 1;
+        if (patch_ != other.patch_) return patch_ < other.patch_ ? -1 : 1;
+
+        // A version without a prerelease has higher precedence.
+        const bool lhsRelease = prerelease_length_ == 0;
+        const bool rhsRelease = other.prerelease_length_ == 0;
+        if (lhsRelease || rhsRelease)
+            return lhsRelease == rhsRelease ? 0 : (lhsRelease ? 1 : -1);
+
+        return detail::compareIdentifiers(prereleaseText(), other.prereleaseText());
+    }
+
+    #ifdef __cpp_impl_three_way_comparison
+        std::weak_ordering
+        operator<=>(const version& other) const noexcept {
+            return compare(other) <=> 0;
+        }
+
+        bool
+        operator==(const version& other) const noexcept {
+            return compare(other) == 0;
+        }
+    #else
+        bool
+        operator==(const version& other) const noexcept {
+            return compare(other) == 0;
+        }
+
+        bool
+        operator!=(const version& other) const noexcept {
+            return compare(other) != 0;
+        }
+
+        bool
+        operator<(const version& other) const noexcept {
+            return compare(other) < 0;
+        }
+
+        bool
+        operator>(const version& other) const noexcept {
+            return compare(other) > 0;
+        }
+
+        bool
+        operator<=(const version& other) const noexcept {
+            return compare(other) <= 0;
+        }
+
+        bool
+        operator>=(const version& other) const noexcept {
+            return compare(other) >= 0;
+        }
+    #endif
+
+private:
+    // Identifier views can be built from unchecked text, which must not end
+    // up in the normal form, so check it as parse() would.
+    void
+    assign(std::string_view prerel, std::string_view meta) {
+        detail::validateIdentifiers(prerel, true);
+        detail::validateIdentifiers(meta, false);
+        store(prerel, meta);
+    }
+
+    // Builds the normal form from the numeric parts and the given text. The
+    // text must already be valid.
+    void
+    store(std::string_view prerel, std::string_view meta) {
+        value_.clear();
+        detail::appendNumeric(value_, major_);
+        value_ += '.';
+        detail::appendNumeric(value_, minor_);
+        value_ += '.';
+        detail::appendNumeric(value_, patch_);
+        if (!prerel.empty()) value_.append(1, '-').append(prerel);
+        if (!meta.empty())   value_.append(1, '+').append(meta);
+
+        prerelease_length_ = prerel.size();
+        build_length_      = meta.size();
+    }
+
+    std::string_view
+    prereleaseText() const noexcept {
+        const auto end = value_.size() - build_length_ - (build_length_ ? 1 : 0);
+        return std::string_view{ value_ }.substr(end - prerelease_length_, prerelease_length_);
+    }
+
+    std::string_view
+    buildText() const noexcept {
+        return std::string_view{ value_ }.substr(value_.size() - build_length_);
+    }
+
+private:
+    // Owns the text so that copies never dangle, the prerelease and build
+    // meta are recovered from its tail.
+    std::string   value_ = "0.0.0";
+    std::uint64_t major_ = 0;
+    std::uint64_t minor_ = 0;
+    std::uint64_t patch_ = 0;
+    std::size_t   prerelease_length_ = 0;
+    std::size_t   build_length_      = 0;
+};
+
+
+// A version with its prerelease and build meta stored inline in a buffer of
+// Capacity bytes. It never allocates, is trivially copyable and can be built
+// and compared in constant expressions, which makes it suitable for real-time
+// threads and shared-memory messages. Text that does not fit is rejected
+// with std::length_error, at compile time when constant evaluated.
+template<std::size_t Capacity,
+         typename Policy = detail::strict_version_parsing_policy>
+class static_version final {
+    static_assert(Capacity <= std::numeric_limits<std::uint16_t>::max(),
+                  "Capacity must fit in 16 bits.");
+
+    // Verify that the policy provides the flags and limits the scanner needs.
+    static_assert(detail::is_parsing_policy_v<Policy>,
+                  "Policy must provide kAllowPrefix, kAllowPartial and kLimits.");
+
+public:
+    constexpr static_version() = default;
+             ~static_version() = default;
+
+    constexpr static_version(const static_version&) = default;
+    constexpr static_version(static_version&&) noexcept = default;
+    constexpr static_version& operator=(const static_version&) = default;
+    constexpr static_version& operator=(static_version&&) noexcept = default;
+
+    constexpr static_version(std::uint64_t major,
+                             std::uint64_t minor,
+                             std::uint64_t patch) noexcept
+        : major_(major)
+        , minor_(minor)
+        , patch_(patch) {}
+
+    constexpr static_version(std::uint64_t major,
+                             std::uint64_t minor,
+                             std::uint64_t patch,
+                             const prerelease& prerel,
+                             const build_meta& meta = build_meta{})
+        : major_(major)
+        , minor_(minor)
+        , patch_(patch) {
+        assign(prerel.str(), meta.str());
+    }
+
+    explicit static_version(const version<Policy>& other)
+        : major_(other.major())
+        , minor_(other.minor())
+        , patch_(other.patch()) {
+        assign(other.pre().str(), other.build().str());
+    }
+
+    constexpr static static_version
+    parse(std::string_view text) {
+        detail::version_fields fields;
+        const auto error = detail::scanVersion<Policy>(text, fields);
+        if (error != parse_error::none)
+            throw std::invalid_argument(describe(error));
+
+        static_version result{ fields.major, fields.minor, fields.patch };
+        result.store(text.substr(fields.prerelease_offset, fields.prerelease_length),
+                      text.substr(fields.build_offset, fields.build_length));
+        return result;
+    }
+
+    version<Policy>
+    to_version() const {
+        return { major_, minor_, patch_, pre(), build() };
+    }
+
+    constexpr std::uint64_t
+    major() const noexcept {
+        return major_;
+    }
+
+    constexpr std::uint64_t
+    minor() const noexcept {
+        return minor_;
+    }
+
+    constexpr std::uint64_t
+    patch() const noexcept {
+        return patch_;
+    }
+
+    constexpr prerelease
+    pre() const noexcept {
+        return prerelease{ prereleaseText() };
+    }
+
+    constexpr build_meta
+    build() const noexcept {
+        return build_meta{ buildText() };
+    }
+
+    // Consistent with compare(), build metadata does not contribute.
+    constexpr std::uint64_t
+    hash() const noexcept {
+        return detail::hashVersion(major_, minor_, patch_, prereleaseText());
+    }
+
+    constexpr static std::size_t
+    capacity() noexcept {
+        return Capacity;
+    }
+
+    // Precedence as defined by semver 2.0.0, build metadata is ignored.
+    constexpr int
+    compare(const static_version& other) const noexcept {
+        if (major_ != other.major_) return major_ < other.major_ ? -1 : 1;
+        if (minor_ != other.minor_) return minor_ < other.minor_ ? -1 : 1;
+        if (patch_ != other.patch_) return patch_ < other.patch_ ? -1 : 1;
+
+        // A version without a prerelease has higher precedence.
+        const bool lhsRelease = prerelease_length_ == 0;
+        const bool rhsRelease = other.prerelease_length_ == 0;
+        if (lhsRelease || rhsRelease)
+            return lhsRelease == rhsRelease ? 0 : (lhsRelease ? 1 : -1);
+
+        const auto count = std::min(identifier_count_, other.identifier_count_);
+        for (std::size_t index = 0; index < count; ++index) {
+            const int result = detail::compareIdentifier(identifier(index),
+                                                         other.identifier(index));
+            if (result != 0) return result;
         }
 
-        // return version<detail::strict_version_parsing_policy>.
-        return { major, minor, patch, prerel, meta };
+        if (identifier_count_ == other.identifier_count_) return 0;
+        return identifier_count_ < other.identifier_count_ ? -1 : 1;
     }
 
+    #ifdef __cpp_impl_three_way_comparison
+        constexpr std::weak_ordering
+        operator<=>(const static_version& other) const noexcept {
+            return compare(other) <=> 0;
+        }
+
+        constexpr bool
+        operator==(const static_version& other) const noexcept {
+            return compare(other) == 0;
+        }
+    #else
+        constexpr bool
+        operator==(const static_version& other) const noexcept {
+            return compare(other) == 0;
+        }
+
+        constexpr bool
+        operator!=(const static_version& other) const noexcept {
+            return compare(other) != 0;
+        }
+
+        constexpr bool
+        operator<(const static_version& other) const noexcept {
+            return compare(other) < 0;
+        }
+
+        constexpr bool
+        operator>(const static_version& other) const noexcept {
+            return compare(other) > 0;
+        }
+
+        constexpr bool
+        operator<=(const static_version& other) const noexcept {
+            return compare(other) <= 0;
+        }
+
+        constexpr bool
+        operator>=(const static_version& other) const noexcept {
+            return compare(other) >= 0;
+        }
+    #endif
+
 private:
-    prerelease prerelease_;
-    build_meta build_meta_;
+    // Identifier views can be built from unchecked text, which would not fit
+    // the identifier table if it held empty identifiers, so check it first.
+    constexpr void
+    assign(std::string_view prerel, std::string_view meta) {
+        detail::validateIdentifiers(prerel, true);
+        detail::validateIdentifiers(meta, false);
+        store(prerel, meta);
+    }
+
+    // Copies the text inline and records where each prerelease identifier
+    // ends, so comparisons never have to search for the delimiters. The
+    // text must already be valid.
+    constexpr void
+    store(std::string_view prerel, std::string_view meta) {
+        if (prerel.size() + meta.size() > Capacity)
+            throw std::length_error("Version text exceeds static_version capacity");
+
+        std::size_t length = 0;
+        for (char c : prerel) {
+            if (c == '.') identifier_ends_[identifier_count_++] = static_cast<std::uint16_t>(length);
+            text_[length++] = c;
+        }
+
+        if (!prerel.empty())
+            identifier_ends_[identifier_count_++] = static_cast<std::uint16_t>(length);
+
+        for (char c : meta)
+            text_[length++] = c;
+
+        prerelease_length_ = static_cast<std::uint16_t>(prerel.size());
+        build_length_      = static_cast<std::uint16_t>(meta.size());
+    }
+
+    constexpr std::string_view
+    identifier(std::size_t index) const noexcept {
+        const std::size_t begin = index == 0 ? 0 : identifier_ends_[index - 1] + 1;
+        return { text_.data() + begin, identifier_ends_[index] - begin };
+    }
+
+    constexpr std::string_view
+    prereleaseText() const noexcept {
+        return { text_.data(), prerelease_length_ };
+    }
+
+    constexpr std::string_view
+    buildText() const noexcept {
+        return { text_.data() + prerelease_length_, build_length_ };
+    }
 
-    std::string   value_;
-    std::uint64_t major_;
-    std::uint64_t minor_;
-    std::uint64_t patch_;
+private:
+    std::uint64_t major_ = 0;
+    std::uint64_t minor_ = 0;
+    std::uint64_t patch_ = 0;
+    std::uint16_t prerelease_length_ = 0;
+    std::uint16_t build_length_      = 0;
+    std::uint16_t identifier_count_  = 0;
+
+    // Identifiers are at least one byte plus a delimiter.
+    std::array<std::uint16_t, (Capacity + 1) / 2> identifier_ends_{};
+    std::array<char, Capacity>                    text_{};
 };
 
 
 } // namespace sk
 
+
+namespace std {
+
+
+template<typename Policy>
+struct hash<sk::version<Policy>> {
+    std::size_t
+    operator()(const sk::version<Policy>& value) const noexcept {
+        return static_cast<std::size_t>(value.hash());
+    }
+};
+
+
+template<std::size_t Capacity, typename Policy>
+struct hash<sk::static_version<Capacity, Policy>> {
+    constexpr std::size_t
+    operator()(const sk::static_version<Capacity, Policy>& value) const noexcept {
+        return static_cast<std::size_t>(value.hash());
+    }
+};
+
+
+} // namespace std
+
 #undef SK_CONSTEXPR
 #endif // SK_SEMVER_HPP
\ No newline at end of file
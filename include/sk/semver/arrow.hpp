@@ -0,0 +1,322 @@
+#ifndef SK_SEMVER_ARROW_HPP
+#define SK_SEMVER_ARROW_HPP
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "sk/semver.hpp"
+
+
+// Structures of the Apache Arrow C Data Interface, copied verbatim from the
+// specification so that no Arrow dependency is required.
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+    // Array type description
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowSchema*);
+    // Opaque producer-specific data
+    void* private_data;
+};
+
+struct ArrowArray {
+    // Array data description
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowArray*);
+    // Opaque producer-specific data
+    void* private_data;
+};
+
+#endif // ARROW_C_DATA_INTERFACE
+
+
+namespace sk {
+
+
+namespace detail {
+
+
+struct arrow_schema_holder final {
+    std::string format;
+    std::string name;
+
+    std::vector<ArrowSchema>  children;
+    std::vector<ArrowSchema*> child_pointers;
+    ArrowSchema               dictionary{};
+};
+
+
+struct arrow_array_holder final {
+    std::vector<std::uint8_t>  validity;
+    std::vector<std::uint64_t> values;
+    std::vector<std::int32_t>  integers;
+    std::string                characters;
+    std::vector<const void*>   buffers;
+
+    std::vector<ArrowArray>  children;
+    std::vector<ArrowArray*> child_pointers;
+    ArrowArray               dictionary{};
+};
+
+
+inline void
+releaseArrowSchema(ArrowSchema* schema) {
+    auto* holder = static_cast<arrow_schema_holder*>(schema->private_data);
+
+    // Consumers may have moved children out, those have a null release.
+    for (auto& child : holder->children)
+        if (child.release) child.release(&child);
+    if (holder->dictionary.release)
+        holder->dictionary.release(&holder->dictionary);
+
+    delete holder;
+    schema->release = nullptr;
+}
+
+
+inline void
+releaseArrowArray(ArrowArray* array) {
+    auto* holder = static_cast<arrow_array_holder*>(array->private_data);
+
+    for (auto& child : holder->children)
+        if (child.release) child.release(&child);
+    if (holder->dictionary.release)
+        holder->dictionary.release(&holder->dictionary);
+
+    delete holder;
+    array->release = nullptr;
+}
+
+
+inline void
+makeArrowSchema(ArrowSchema& schema,
+                std::string_view format,
+                std::string_view name,
+                std::int64_t flags,
+                std::size_t childCount) {
+    auto holder = std::make_unique<arrow_schema_holder>();
+    holder->format = format;
+    holder->name   = name;
+    holder->children.resize(childCount);
+    for (auto& child : holder->children)
+        holder->child_pointers.push_back(&child);
+
+    schema.format       = holder->format.c_str();
+    schema.name         = holder->name.c_str();
+    schema.metadata     = nullptr;
+    schema.flags        = flags;
+    schema.n_children   = static_cast<std::int64_t>(childCount);
+    schema.children     = childCount ? holder->child_pointers.data() : nullptr;
+    schema.dictionary   = nullptr;
+    schema.release      = releaseArrowSchema;
+    schema.private_data = holder.release();
+}
+
+
+// Allocates the children up front, publishing must not allocate.
+inline void
+makeArrowChildren(arrow_array_holder& holder, std::size_t count) {
+    holder.children.resize(count);
+    holder.child_pointers.reserve(count);
+    for (auto& child : holder.children)
+        holder.child_pointers.push_back(&child);
+}
+
+
+inline void
+publishArrowArray(ArrowArray& array,
+                  std::unique_ptr<arrow_array_holder> holder,
+                  std::int64_t length,
+                  std::int64_t nullCount) noexcept {
+    array.length       = length;
+    array.null_count   = nullCount;
+    array.offset       = 0;
+    array.n_buffers    = static_cast<std::int64_t>(holder->buffers.size());
+    array.n_children   = static_cast<std::int64_t>(holder->children.size());
+    array.buffers      = holder->buffers.data();
+    array.children     = holder->children.empty() ? nullptr : holder->child_pointers.data();
+    array.dictionary   = holder->dictionary.release ? &holder->dictionary : nullptr;
+    array.release      = releaseArrowArray;
+    array.private_data = holder.release();
+}
+
+
+inline std::unique_ptr<arrow_array_holder>
+makeUInt64Column(std::vector<std::uint64_t> values) {
+    auto holder = std::make_unique<arrow_array_holder>();
+    holder->values  = std::move(values);
+    holder->buffers = { nullptr, holder->values.data() };
+    return holder;
+}
+
+
+// Dictionary encodes the text of one column, empty text becomes null.
+class arrow_dictionary_builder final {
+public:
+    explicit arrow_dictionary_builder(std::size_t length)
+        : indices_(std::make_unique<arrow_array_holder>())
+        , entries_(std::make_unique<arrow_array_holder>()) {
+        indices_->validity.assign((length + 7) / 8, 0);
+        indices_->integers.reserve(length);
+        entries_->integers.push_back(0);
+    }
+
+    void
+    append(std::string_view text) {
+        const auto row = indices_->integers.size();
+        if (text.empty()) {
+            indices_->integers.push_back(0);
+            ++null_count_;
+            return;
+        }
+
+        auto found = lookup_.find(text);
+        if (found == lookup_.end()) {
+            if (entries_->characters.size() + text.size() >
+                static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max()))
+                throw std::length_error("Dictionary exceeds 32-bit Arrow offsets");
+
+            const auto index = static_cast<std::int32_t>(lookup_.size());
+            entries_->characters.append(text);
+            entries_->integers.push_back(static_cast<std::int32_t>(entries_->characters.size()));
+            found = lookup_.emplace(text, index).first;
+        }
+
+        indices_->validity[row / 8] |= static_cast<std::uint8_t>(1u << (row % 8));
+        indices_->integers.push_back(found->second);
+    }
+
+    // Sets up the buffer lists, the last step that may throw.
+    void
+    prepare() {
+        entries_->buffers = { nullptr,
+                              entries_->integers.data(),
+                              entries_->characters.data() };
+
+        indices_->buffers = { null_count_ ? indices_->validity.data() : nullptr,
+                              indices_->integers.data() };
+    }
+
+    // Hands both arrays over, the builder must not be used afterwards.
+    void
+    publish(ArrowArray& array) noexcept {
+        const auto length = static_cast<std::int64_t>(indices_->integers.size());
+        publishArrowArray(indices_->dictionary, std::move(entries_),
+                          static_cast<std::int64_t>(lookup_.size()), 0);
+        publishArrowArray(array, std::move(indices_), length,
+                          static_cast<std::int64_t>(null_count_));
+    }
+
+private:
+    std::unique_ptr<arrow_array_holder> indices_;
+    std::unique_ptr<arrow_array_holder> entries_;
+    std::unordered_map<std::string_view, std::int32_t> lookup_;
+    std::size_t null_count_ = 0;
+};
+
+
+} // namespace sk::detail
+
+
+// Exports the versions in [first, last) through the Arrow C Data Interface
+// as a struct of uint64 major, minor and patch columns and dictionary encoded
+// prerelease and build columns, which are null where a version has none.
+// Consumers import the result without copying and own it from then on, the
+// versions only need to live for the duration of the call.
+template<typename Iterator>
+void
+export_arrow(Iterator first,
+             Iterator last,
+             ArrowSchema* schema,
+             ArrowArray* array) {
+    constexpr std::string_view kColumns[] = {
+        "major", "minor", "patch", "prerelease", "build"
+    };
+
+    const auto length = static_cast<std::size_t>(std::distance(first, last));
+    std::vector<std::uint64_t> majors, minors, patches;
+    majors.reserve(length);
+    minors.reserve(length);
+    patches.reserve(length);
+
+    detail::arrow_dictionary_builder prereleases(length);
+    detail::arrow_dictionary_builder builds(length);
+    for (auto current = first; current != last; ++current) {
+        majors.push_back(current->major());
+        minors.push_back(current->minor());
+        patches.push_back(current->patch());
+        prereleases.append(current->pre().str());
+        builds.append(current->build().str());
+    }
+
+    // Everything that can throw happens before the first array is published.
+    auto root = std::make_unique<detail::arrow_array_holder>();
+    root->buffers = { nullptr };
+    detail::makeArrowChildren(*root, std::size(kColumns));
+    prereleases.prepare();
+    builds.prepare();
+
+    auto majorColumn = detail::makeUInt64Column(std::move(majors));
+    auto minorColumn = detail::makeUInt64Column(std::move(minors));
+    auto patchColumn = detail::makeUInt64Column(std::move(patches));
+
+    ArrowSchema result{};
+    detail::makeArrowSchema(result, "+s", "", 0, std::size(kColumns));
+    try {
+        for (std::size_t index = 0; index < 3; ++index)
+            detail::makeArrowSchema(*result.children[index], "L", kColumns[index], 0, 0);
+
+        for (std::size_t index = 3; index < std::size(kColumns); ++index) {
+            auto& column = *result.children[index];
+            detail::makeArrowSchema(column, "i", kColumns[index], ARROW_FLAG_NULLABLE, 0);
+
+            auto* holder = static_cast<detail::arrow_schema_holder*>(column.private_data);
+            detail::makeArrowSchema(holder->dictionary, "u", "", 0, 0);
+            column.dictionary = &holder->dictionary;
+        }
+    } catch (...) {
+        result.release(&result);
+        throw;
+    }
+
+    detail::publishArrowArray(root->children[0], std::move(majorColumn), length, 0);
+    detail::publishArrowArray(root->children[1], std::move(minorColumn), length, 0);
+    detail::publishArrowArray(root->children[2], std::move(patchColumn), length, 0);
+    prereleases.publish(root->children[3]);
+    builds.publish(root->children[4]);
+    detail::publishArrowArray(*array, std::move(root), length, 0);
+    *schema = result;
+}
+
+
+} // namespace sk
+
+#endif // SK_SEMVER_ARROW_HPP
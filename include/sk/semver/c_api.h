@@ -0,0 +1,129 @@
+#ifndef SK_SEMVER_C_API_H
+#define SK_SEMVER_C_API_H
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Every entry point works on arrays so a single foreign call can cover
+ * thousands of versions. Nothing here retains a pointer past the call.
+ * Parsing, comparing and interval matching never allocate, sorting may
+ * allocate a scratch buffer and falls back to a slower in-place sort when it
+ * cannot. */
+
+
+#if defined(_WIN32) && defined(SK_SEMVER_C_BUILD)
+#   define SK_SEMVER_C_API __declspec(dllexport)
+#elif defined(_WIN32)
+#   define SK_SEMVER_C_API __declspec(dllimport)
+#else
+#   define SK_SEMVER_C_API __attribute__((visibility("default")))
+#endif
+
+
+/* Mirrors sk::parse_error, values are part of the ABI. */
+typedef enum sk_semver_status {
+    SK_SEMVER_OK                   = 0,
+    SK_SEMVER_EMPTY                = 1,
+    SK_SEMVER_TOO_LONG             = 2,
+    SK_SEMVER_MISSING_MAJOR        = 3,
+    SK_SEMVER_MISSING_MINOR        = 4,
+    SK_SEMVER_MISSING_PATCH        = 5,
+    SK_SEMVER_LEADING_ZERO         = 6,
+    SK_SEMVER_NUMERIC_TOO_LONG     = 7,
+    SK_SEMVER_NUMERIC_OVERFLOW     = 8,
+    SK_SEMVER_EMPTY_IDENTIFIER     = 9,
+    SK_SEMVER_TOO_MANY_IDENTIFIERS = 10,
+    SK_SEMVER_PRERELEASE_TOO_LONG  = 11,
+    SK_SEMVER_BUILD_TOO_LONG       = 12,
+    SK_SEMVER_INVALID_CHARACTER    = 13
+} sk_semver_status;
+
+
+typedef enum sk_semver_flags {
+    SK_SEMVER_STRICT = 0,
+    SK_SEMVER_LOOSE  = 1
+} sk_semver_flags;
+
+
+/* A parsed version. The prerelease and build point into the input that was
+ * parsed and are only valid for as long as that input is. */
+typedef struct sk_semver {
+    uint64_t    major;
+    uint64_t    minor;
+    uint64_t    patch;
+    const char* prerelease;
+    size_t      prerelease_length;
+    const char* build;
+    size_t      build_length;
+} sk_semver;
+
+
+/* Half-open interval [lower, upper) of versions, a NULL bound is unbounded.
+ * ^1.2.3 is [1.2.3, 2.0.0-0). */
+typedef struct sk_semver_interval {
+    const sk_semver* lower;
+    const sk_semver* upper;
+} sk_semver_interval;
+
+
+/* Parses count strings into out. lengths may be NULL for NUL terminated
+ * input. status receives the outcome of each element, failed elements are
+ * zeroed. Returns the number of elements parsed successfully. */
+SK_SEMVER_C_API size_t
+sk_semver_parse_n(const char* const* texts,
+                  const size_t*      lengths,
+                  size_t             count,
+                  sk_semver_flags    flags,
+                  sk_semver*         out,
+                  sk_semver_status*  status);
+
+/* Same as sk_semver_parse_n for strings packed into one buffer, string i is
+ * buffer[offsets[i], offsets[i + 1]), so offsets holds count + 1 entries. */
+SK_SEMVER_C_API size_t
+sk_semver_parse_packed(const char*       buffer,
+                       const size_t*     offsets,
+                       size_t            count,
+                       sk_semver_flags   flags,
+                       sk_semver*        out,
+                       sk_semver_status* status);
+
+/* Writes -1, 0 or 1 to result[i] for the precedence of lhs[i] against
+ * rhs[i]. Build metadata is ignored. */
+SK_SEMVER_C_API void
+sk_semver_compare_n(const sk_semver* lhs,
+                    const sk_semver* rhs,
+                    size_t           count,
+                    int*             result);
+
+/* Writes 1 to result[i] when versions[i] lies within any of the
+ * interval_count intervals, else 0. A range with alternatives such as
+ * "^1.2 || ^2.1" is one interval per alternative, they need not be sorted
+ * and may overlap. */
+SK_SEMVER_C_API void
+sk_semver_in_intervals_n(const sk_semver*          versions,
+                         size_t                    count,
+                         const sk_semver_interval* intervals,
+                         size_t                    interval_count,
+                         int*                      result);
+
+/* Stable sort by precedence, in place. */
+SK_SEMVER_C_API void
+sk_semver_sort(sk_semver* versions, size_t count);
+
+/* Writes the permutation that would sort versions into indices. */
+SK_SEMVER_C_API void
+sk_semver_argsort(const sk_semver* versions, size_t count, size_t* indices);
+
+SK_SEMVER_C_API const char*
+sk_semver_status_string(sk_semver_status status);
+
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // SK_SEMVER_C_API_H
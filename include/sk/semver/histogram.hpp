@@ -0,0 +1,358 @@
+#ifndef SK_SEMVER_HISTOGRAM_HPP
+#define SK_SEMVER_HISTOGRAM_HPP
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+
+// Latency histograms around the library's entry points. Only compiled into
+// the library's hot paths when SK_SEMVER_HISTOGRAMS is defined, otherwise
+// SK_SEMVER_TIME_SCOPE expands to nothing and this header is never included.
+//
+// Each thread records into its own histograms with plain relaxed stores, so
+// recording never contends. Histograms are merged on demand when read, and
+// a thread's histograms are folded into a shared total when it exits.
+
+
+namespace sk::histograms {
+
+
+enum class metric : std::uint8_t {
+    parse,
+    interval_build,
+    interval_lookup,
+    known_lookup,
+    upgrade,
+    max_satisfying,
+    count,
+};
+
+
+constexpr const char*
+name(metric value) noexcept {
+    switch (value) {
+    case metric::parse:           return "parse";
+    case metric::interval_build:  return "interval_build";
+    case metric::interval_lookup: return "interval_lookup";
+    case metric::known_lookup:    return "known_lookup";
+    case metric::upgrade:         return "upgrade";
+    case metric::max_satisfying:  return "max_satisfying";
+    case metric::count:           break;
+    }
+
+    return "unknown";
+}
+
+
+constexpr std::size_t kMetrics = static_cast<std::size_t>(metric::count);
+
+// Log-linear buckets as in HdrHistogram: 8 linear sub-buckets per power of
+// two, about 12% relative precision, nanoseconds up to 2^40 (~18 minutes).
+constexpr std::size_t   kSubBucketBits = 3;
+constexpr std::size_t   kSubBuckets    = std::size_t{ 1 } << kSubBucketBits;
+constexpr std::size_t   kMaxBits       = 40;
+constexpr std::size_t   kBuckets       = (kMaxBits - kSubBucketBits + 1) * kSubBuckets;
+constexpr std::uint64_t kMaxValue      = (std::uint64_t{ 1 } << kMaxBits) - 1;
+
+
+constexpr std::size_t
+bucketOf(std::uint64_t nanos) noexcept {
+    if (nanos > kMaxValue) nanos = kMaxValue;
+    if (nanos < kSubBuckets) return static_cast<std::size_t>(nanos);
+
+    const auto msb   = static_cast<std::size_t>(63 - std::countl_zero(nanos));
+    const auto shift = msb - kSubBucketBits;
+    return (shift + 1) * kSubBuckets + static_cast<std::size_t>((nanos >> shift) & (kSubBuckets - 1));
+}
+
+
+// Exclusive upper bound of a bucket in nanoseconds.
+constexpr std::uint64_t
+bucketLimit(std::size_t bucket) noexcept {
+    if (bucket < kSubBuckets) return bucket + 1;
+
+    const auto shift = bucket / kSubBuckets - 1;
+    const auto sub   = bucket % kSubBuckets;
+    return (std::uint64_t{ kSubBuckets + sub + 1 }) << shift;
+}
+
+
+struct snapshot final {
+    std::array<std::uint64_t, kBuckets> counts{};
+    std::uint64_t count = 0;
+    std::uint64_t sum   = 0;
+
+    void
+    merge(const snapshot& other) noexcept {
+        for (std::size_t bucket = 0; bucket < kBuckets; ++bucket)
+            counts[bucket] += other.counts[bucket];
+        count += other.count;
+        sum   += other.sum;
+    }
+
+    // Upper bound of the bucket holding the given quantile, in nanoseconds.
+    // The quantile is the sample of rank ceil(fraction * count), so 1.0 is
+    // the largest sample rather than one past it.
+    std::uint64_t
+    percentile(double fraction) const noexcept {
+        if (count == 0)
+            return 0;
+
+        const auto total = static_cast<double>(count);
+        const auto rank  = std::ceil(fraction * total);
+        const auto target = !(rank > 1.0) ? std::uint64_t{ 1 }
+                          : rank < total  ? static_cast<std::uint64_t>(rank)
+                                          : count;
+
+        std::uint64_t seen = 0;
+        for (std::size_t bucket = 0; bucket < kBuckets; ++bucket) {
+            seen += counts[bucket];
+            if (seen >= target) return bucketLimit(bucket);
+        }
+
+        return kMaxValue;
+    }
+};
+
+
+namespace detail {
+
+
+struct thread_histograms final {
+    std::array<std::array<std::atomic<std::uint64_t>, kBuckets>, kMetrics> counts{};
+    std::array<std::atomic<std::uint64_t>, kMetrics> sums{};
+};
+
+
+// Live threads are listed individually, threads that exited are folded
+// into retired so the registry never grows past the number of live threads.
+struct registry final {
+    std::mutex                       mutex;
+    std::vector<thread_histograms*>  threads;
+    thread_histograms                retired;
+    std::atomic<std::uint32_t>       sample_every{ 1 };
+};
+
+
+inline registry&
+globalRegistry() noexcept {
+    static registry instance;
+    return instance;
+}
+
+
+// Only the owning thread writes, a relaxed load and store is enough.
+inline void
+bump(std::atomic<std::uint64_t>& counter, std::uint64_t amount) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + amount,
+                  std::memory_order_relaxed);
+}
+
+
+// Adds every count of from into into. Callers hold the registry mutex.
+inline void
+fold(thread_histograms& into, const thread_histograms& from) noexcept {
+    for (std::size_t index = 0; index < kMetrics; ++index) {
+        for (std::size_t bucket = 0; bucket < kBuckets; ++bucket)
+            bump(into.counts[index][bucket],
+                 from.counts[index][bucket].load(std::memory_order_relaxed));
+        bump(into.sums[index], from.sums[index].load(std::memory_order_relaxed));
+    }
+}
+
+
+// Registers the thread's histograms on first use and, when the thread
+// exits, folds them into the retired totals so nothing recorded is lost.
+class thread_owner final {
+public:
+    thread_owner() noexcept {
+        try {
+            auto created = std::make_unique<thread_histograms>();
+            auto& global = globalRegistry();
+            std::lock_guard lock{ global.mutex };
+            global.threads.push_back(created.get());
+            histograms_ = std::move(created);
+        } catch (const std::exception&) {
+            histograms_.reset();
+        }
+    }
+
+    ~thread_owner() {
+        if (!histograms_)
+            return;
+
+        auto& global = globalRegistry();
+        std::lock_guard lock{ global.mutex };
+        fold(global.retired, *histograms_);
+        auto& threads = global.threads;
+        threads.erase(std::find(threads.begin(), threads.end(), histograms_.get()));
+    }
+
+    thread_owner(const thread_owner&) = delete;
+    thread_owner& operator=(const thread_owner&) = delete;
+
+    thread_histograms*
+    get() const noexcept {
+        return histograms_.get();
+    }
+
+private:
+    std::unique_ptr<thread_histograms> histograms_;
+};
+
+
+// Null if registration ran out of memory.
+inline thread_histograms*
+local() noexcept {
+    thread_local thread_owner owner;
+    return owner.get();
+}
+
+
+// Counted per metric, timers nest and a shared count would let the inner
+// metric take every sample.
+inline bool
+sampled(metric which) noexcept {
+    thread_local std::array<std::uint32_t, kMetrics> ticks{};
+    auto& tick = ticks[static_cast<std::size_t>(which)];
+    if (++tick < globalRegistry().sample_every.load(std::memory_order_relaxed))
+        return false;
+
+    tick = 0;
+    return true;
+}
+
+
+} // namespace sk::histograms::detail
+
+
+// Record one call in every sample_every calls per thread and metric, 1
+// records all.
+inline void
+set_sample_every(std::uint32_t calls) noexcept {
+    detail::globalRegistry().sample_every.store(calls ? calls : 1, std::memory_order_relaxed);
+}
+
+
+inline void
+record(metric which, std::uint64_t nanos) noexcept {
+    auto* histograms = detail::local();
+    if (histograms == nullptr)
+        return;
+
+    const auto index = static_cast<std::size_t>(which);
+    detail::bump(histograms->counts[index][bucketOf(nanos)], 1);
+    detail::bump(histograms->sums[index], nanos);
+}
+
+
+// Merges every live thread's histogram for one metric with what threads
+// that already exited recorded.
+inline snapshot
+collect(metric which) {
+    const auto index = static_cast<std::size_t>(which);
+    auto& global = detail::globalRegistry();
+
+    snapshot result;
+    const auto add = [&](const detail::thread_histograms& thread) {
+        for (std::size_t bucket = 0; bucket < kBuckets; ++bucket) {
+            const auto count = thread.counts[index][bucket].load(std::memory_order_relaxed);
+            result.counts[bucket] += count;
+            result.count          += count;
+        }
+
+        result.sum += thread.sums[index].load(std::memory_order_relaxed);
+    };
+
+    std::lock_guard lock{ global.mutex };
+    add(global.retired);
+    for (const auto* thread : global.threads)
+        add(*thread);
+
+    return result;
+}
+
+
+// Writes all metrics in the Prometheus text format. The file is replaced
+// atomically so a scraper never sees a partial write.
+inline bool
+write_prometheus(const std::string& path) {
+    const auto temporary = path + ".tmp";
+    std::FILE* out = std::fopen(temporary.c_str(), "w");
+    if (out == nullptr)
+        return false;
+
+    std::fprintf(out, "# HELP sk_semver_latency_ns Latency of sk::semver operations.\n");
+    std::fprintf(out, "# TYPE sk_semver_latency_ns histogram\n");
+    for (std::size_t index = 0; index < kMetrics; ++index) {
+        const auto which = static_cast<metric>(index);
+        const auto data  = collect(which);
+
+        std::uint64_t cumulative = 0;
+        for (std::size_t bucket = 0; bucket < kBuckets; ++bucket) {
+            if (data.counts[bucket] == 0) continue;
+            cumulative += data.counts[bucket];
+            std::fprintf(out, "sk_semver_latency_ns_bucket{op=\"%s\",le=\"%llu\"} %llu\n",
+                         name(which),
+                         static_cast<unsigned long long>(bucketLimit(bucket)),
+                         static_cast<unsigned long long>(cumulative));
+        }
+
+        std::fprintf(out, "sk_semver_latency_ns_bucket{op=\"%s\",le=\"+Inf\"} %llu\n",
+                     name(which), static_cast<unsigned long long>(data.count));
+        std::fprintf(out, "sk_semver_latency_ns_sum{op=\"%s\"} %llu\n",
+                     name(which), static_cast<unsigned long long>(data.sum));
+        std::fprintf(out, "sk_semver_latency_ns_count{op=\"%s\"} %llu\n",
+                     name(which), static_cast<unsigned long long>(data.count));
+    }
+
+    std::fprintf(out, "# TYPE sk_semver_latency_sample_every gauge\n");
+    std::fprintf(out, "sk_semver_latency_sample_every %u\n",
+                 detail::globalRegistry().sample_every.load(std::memory_order_relaxed));
+
+    const bool written = std::fclose(out) == 0;
+    return written && std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+
+class scoped_timer final {
+    using clock = std::chrono::steady_clock;
+
+public:
+    explicit scoped_timer(metric which) noexcept
+        : which_(which)
+        , active_(detail::sampled(which)) {
+        if (active_) start_ = clock::now();
+    }
+
+    ~scoped_timer() {
+        if (!active_) return;
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start_);
+        record(which_, static_cast<std::uint64_t>(elapsed.count()));
+    }
+
+    scoped_timer(const scoped_timer&) = delete;
+    scoped_timer& operator=(const scoped_timer&) = delete;
+
+private:
+    metric            which_;
+    bool              active_;
+    clock::time_point start_{};
+};
+
+
+} // namespace sk::histograms
+
+#endif // SK_SEMVER_HISTOGRAM_HPP
@@ -0,0 +1,351 @@
+#ifndef SK_SEMVER_KNOWN_VERSIONS_HPP
+#define SK_SEMVER_KNOWN_VERSIONS_HPP
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "sk/semver.hpp"
+
+
+namespace sk {
+
+
+// Fixed-size record of one member. The numeric core is exact, the
+// prerelease is stored in the set's text pool and also reduced to a 64-bit
+// fingerprint for hashing. A lookup compares the fingerprint first and the
+// pooled text after, so a fingerprint collision can never make a stranger a
+// member. Build meta is ignored just as it is for precedence.
+struct version_key final {
+    std::uint64_t major       = 0;
+    std::uint64_t minor       = 0;
+    std::uint64_t patch       = 0;
+    std::uint64_t prerelease  = 0;
+    std::uint32_t text_offset = 0;
+    std::uint32_t text_length = 0;
+};
+
+
+namespace detail {
+
+
+constexpr std::uint64_t
+hashKey(std::uint64_t major,
+        std::uint64_t minor,
+        std::uint64_t patch,
+        std::uint64_t fingerprint,
+        std::uint64_t seed) noexcept {
+    std::uint64_t result = mix64(seed ^ major);
+    result = mix64(result ^ minor);
+    result = mix64(result ^ patch);
+    return mix64(result ^ fingerprint);
+}
+
+
+constexpr std::uint64_t
+hashKey(const version_key& key, std::uint64_t seed) noexcept {
+    return hashKey(key.major, key.minor, key.patch, key.prerelease, seed);
+}
+
+
+} // namespace sk::detail
+
+
+// Set of known versions, e.g. an allowlist or denylist, behind a minimal
+// perfect hash: a lookup is one bucket hash, one slot hash and one exact
+// comparison, whatever the size of the set. Sets are built at runtime with
+// build(), loaded from a file written by save(), or compiled in from a
+// header emitted by the semver_phf tool. Sets are immutable, reloading
+// means building a new set and swapping it in.
+class known_version_set final {
+    constexpr static char          kMagic[4] = { 'S', 'K', 'V', 'S' };
+    constexpr static std::uint32_t kFormat   = 2;
+
+    struct storage final {
+        std::vector<std::int32_t> displacements;
+        std::vector<version_key>  keys;
+        std::string               text;
+    };
+
+public:
+    known_version_set() = default;
+    ~known_version_set() = default;
+
+    known_version_set(const known_version_set&) = default;
+    known_version_set(known_version_set&&) noexcept = default;
+    known_version_set& operator=(const known_version_set&) = default;
+    known_version_set& operator=(known_version_set&&) noexcept = default;
+
+    // Wraps tables that live elsewhere, such as generated static arrays.
+    constexpr known_version_set(const std::int32_t* displacements,
+                                const version_key*  keys,
+                                std::size_t         size,
+                                std::string_view    text) noexcept
+        : displacements_(displacements)
+        , keys_(keys)
+        , size_(size)
+        , text_(text) {}
+
+    template<typename Version>
+    static known_version_set
+    build(const std::vector<Version>& versions) {
+        struct member final {
+            version_key      key;
+            std::string_view text;
+
+            bool
+            operator<(const member& other) const noexcept {
+                return std::tie(key.major, key.minor, key.patch, text) <
+                       std::tie(other.key.major, other.key.minor, other.key.patch, other.text);
+            }
+
+            bool
+            operator==(const member& other) const noexcept {
+                return key.major == other.key.major && key.minor == other.key.minor &&
+                       key.patch == other.key.patch && text == other.text;
+            }
+        };
+
+        std::vector<member> members;
+        members.reserve(versions.size());
+        for (const auto& value : versions) {
+            const auto text = value.pre().str();
+            members.push_back({ { value.major(), value.minor(), value.patch(),
+                                  detail::fnv1a(text) }, text });
+        }
+
+        std::sort(members.begin(), members.end());
+        members.erase(std::unique(members.begin(), members.end()), members.end());
+
+        const auto size = members.size();
+        if (size > static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max()))
+            throw std::length_error("Too many versions for a known_version_set");
+
+        // Distinct members that hash alike for every seed could never be
+        // placed, they only differ in a prerelease with a colliding
+        // fingerprint.
+        for (std::size_t index = 1; index < size; ++index) {
+            const auto& lhs = members[index - 1].key;
+            const auto& rhs = members[index].key;
+            if (lhs.major == rhs.major && lhs.minor == rhs.minor &&
+                lhs.patch == rhs.patch && lhs.prerelease == rhs.prerelease)
+                throw std::invalid_argument("Prerelease fingerprint collision in known_version_set");
+        }
+
+        auto owned = std::make_shared<storage>();
+        for (auto& entry : members) {
+            if (owned->text.size() + entry.text.size() > std::numeric_limits<std::uint32_t>::max())
+                throw std::length_error("Too much prerelease text for a known_version_set");
+
+            entry.key.text_offset = static_cast<std::uint32_t>(owned->text.size());
+            entry.key.text_length = static_cast<std::uint32_t>(entry.text.size());
+            owned->text.append(entry.text);
+        }
+
+        std::vector<std::vector<std::size_t>> buckets(size);
+        for (std::size_t index = 0; index < size; ++index)
+            buckets[detail::hashKey(members[index].key, 0) % size].push_back(index);
+
+        // Place the largest buckets first while the table is still empty.
+        std::vector<std::size_t> order(size);
+        for (std::size_t index = 0; index < size; ++index)
+            order[index] = index;
+        std::stable_sort(order.begin(), order.end(), [&](std::size_t lhs, std::size_t rhs) {
+            return buckets[lhs].size() > buckets[rhs].size();
+        });
+
+        owned->displacements.assign(size, 0);
+        owned->keys.resize(size);
+        std::vector<bool> taken(size, false);
+        std::vector<std::size_t> slots;
+
+        std::size_t position = 0;
+        for (; position < size && buckets[order[position]].size() > 1; ++position) {
+            const auto& bucket = buckets[order[position]];
+            for (std::uint64_t seed = 1;; ++seed) {
+                slots.clear();
+                for (auto index : bucket) {
+                    const auto slot = detail::hashKey(members[index].key, seed) % size;
+                    if (taken[slot] || std::find(slots.begin(), slots.end(), slot) != slots.end())
+                        break;
+                    slots.push_back(slot);
+                }
+
+                if (slots.size() != bucket.size())
+                    continue;
+
+                for (std::size_t index = 0; index < bucket.size(); ++index) {
+                    taken[slots[index]] = true;
+                    owned->keys[slots[index]] = members[bucket[index]].key;
+                }
+
+                owned->displacements[order[position]] = static_cast<std::int32_t>(seed);
+                break;
+            }
+        }
+
+        // Single-key buckets point straight at a free slot, encoded negative.
+        std::size_t free = 0;
+        for (; position < size && buckets[order[position]].size() == 1; ++position) {
+            while (taken[free]) ++free;
+            taken[free] = true;
+            owned->keys[free] = members[buckets[order[position]].front()].key;
+            owned->displacements[order[position]] = -static_cast<std::int32_t>(free) - 1;
+        }
+
+        return adopt(std::move(owned));
+    }
+
+    static known_version_set
+    load(const std::string& path) {
+        std::ifstream in{ path, std::ios::binary };
+        char magic[4] = {};
+        std::uint32_t format = 0;
+        std::uint64_t size   = 0;
+        std::uint64_t text   = 0;
+        in.read(magic, sizeof(magic));
+        in.read(reinterpret_cast<char*>(&format), sizeof(format));
+        in.read(reinterpret_cast<char*>(&size), sizeof(size));
+        in.read(reinterpret_cast<char*>(&text), sizeof(text));
+        if (!in || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 || format != kFormat)
+            throw std::runtime_error("Not a known version set: " + path);
+
+        // Files are refreshed from elsewhere, so check the header against the
+        // actual payload before trusting it with an allocation.
+        constexpr std::uint64_t kRecord = sizeof(std::int32_t) + sizeof(version_key);
+        if (size > static_cast<std::uint64_t>(std::numeric_limits<std::int32_t>::max()) ||
+            text > std::numeric_limits<std::uint32_t>::max())
+            throw std::runtime_error("Corrupt known version set: " + path);
+
+        const auto payload = in.tellg();
+        in.seekg(0, std::ios::end);
+        const auto end = in.tellg();
+        in.seekg(payload);
+        if (!in || payload < 0 || end < payload ||
+            static_cast<std::uint64_t>(end - payload) != size * kRecord + text)
+            throw std::runtime_error("Corrupt known version set: " + path);
+
+        auto owned = std::make_shared<storage>();
+        owned->displacements.resize(size);
+        owned->keys.resize(size);
+        owned->text.resize(text);
+        in.read(reinterpret_cast<char*>(owned->displacements.data()),
+                static_cast<std::streamsize>(size * sizeof(std::int32_t)));
+        in.read(reinterpret_cast<char*>(owned->keys.data()),
+                static_cast<std::streamsize>(size * sizeof(version_key)));
+        in.read(owned->text.data(), static_cast<std::streamsize>(text));
+        if (!in)
+            throw std::runtime_error("Truncated known version set: " + path);
+
+        // A negative displacement names a slot directly and must be in range,
+        // and every key's prerelease must lie within the text pool.
+        for (const auto displacement : owned->displacements) {
+            if (displacement < 0 && -static_cast<std::int64_t>(displacement) - 1 >=
+                                        static_cast<std::int64_t>(size))
+                throw std::runtime_error("Corrupt known version set: " + path);
+        }
+
+        for (const auto& key : owned->keys) {
+            if (std::uint64_t{ key.text_offset } + key.text_length > text)
+                throw std::runtime_error("Corrupt known version set: " + path);
+        }
+
+        return adopt(std::move(owned));
+    }
+
+    // Native byte order, files are meant for hosts of the same architecture.
+    void
+    save(const std::string& path) const {
+        std::ofstream out{ path, std::ios::binary | std::ios::trunc };
+        const std::uint64_t size = size_;
+        const std::uint64_t text = text_.size();
+        out.write(kMagic, sizeof(kMagic));
+        out.write(reinterpret_cast<const char*>(&kFormat), sizeof(kFormat));
+        out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        out.write(reinterpret_cast<const char*>(&text), sizeof(text));
+        out.write(reinterpret_cast<const char*>(displacements_),
+                  static_cast<std::streamsize>(size_ * sizeof(std::int32_t)));
+        out.write(reinterpret_cast<const char*>(keys_),
+                  static_cast<std::streamsize>(size_ * sizeof(version_key)));
+        out.write(text_.data(), static_cast<std::streamsize>(text_.size()));
+        if (!out)
+            throw std::runtime_error("Failed to write known version set: " + path);
+    }
+
+    bool
+    contains(std::uint64_t     major,
+             std::uint64_t     minor,
+             std::uint64_t     patch,
+             std::string_view  prerelease) const noexcept {
+        SK_SEMVER_TIME_SCOPE(known_lookup);
+        if (size_ == 0)
+            return false;
+
+        const auto fingerprint  = detail::fnv1a(prerelease);
+        const auto displacement = displacements_[detail::hashKey(major, minor, patch, fingerprint, 0) % size_];
+        const auto slot = displacement < 0
+            ? static_cast<std::size_t>(-displacement - 1)
+            : detail::hashKey(major, minor, patch, fingerprint,
+                              static_cast<std::uint64_t>(displacement)) % size_;
+
+        const auto& key = keys_[slot];
+        return key.major == major && key.minor == minor && key.patch == patch &&
+               key.prerelease == fingerprint &&
+               text_.substr(key.text_offset, key.text_length) == prerelease;
+    }
+
+    template<typename Version>
+    bool
+    contains(const Version& value) const noexcept {
+        return contains(value.major(), value.minor(), value.patch(), value.pre().str());
+    }
+
+    std::size_t
+    size() const noexcept {
+        return size_;
+    }
+
+    const std::int32_t*
+    displacements() const noexcept {
+        return displacements_;
+    }
+
+    const version_key*
+    keys() const noexcept {
+        return keys_;
+    }
+
+    // Prerelease text of every member, concatenated.
+    std::string_view
+    text() const noexcept {
+        return text_;
+    }
+
+private:
+    static known_version_set
+    adopt(std::shared_ptr<storage> owned) {
+        known_version_set result{ owned->displacements.data(), owned->keys.data(),
+                                  owned->keys.size(), owned->text };
+        result.owned_ = std::move(owned);
+        return result;
+    }
+
+private:
+    const std::int32_t*            displacements_ = nullptr;
+    const version_key*             keys_          = nullptr;
+    std::size_t                    size_          = 0;
+    std::string_view               text_;
+    std::shared_ptr<const storage> owned_;
+};
+
+
+} // namespace sk
+
+#endif // SK_SEMVER_KNOWN_VERSIONS_HPP
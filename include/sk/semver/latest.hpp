@@ -0,0 +1,178 @@
+#ifndef SK_SEMVER_LATEST_HPP
+#define SK_SEMVER_LATEST_HPP
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "sk/semver.hpp"
+
+
+namespace sk {
+
+
+namespace detail {
+
+
+struct package_name_hash final {
+    using is_transparent = void;
+
+    std::size_t
+    operator()(std::string_view name) const noexcept {
+        return std::hash<std::string_view>{}(name);
+    }
+};
+
+
+} // namespace sk::detail
+
+
+// Incrementally tracks the latest versions of each package from a feed of
+// publish events, so the latest set never has to be recomputed from the
+// full catalog. Each update costs one hash lookup and a handful of version
+// comparisons. The tracker is fed from a single writer thread, which is
+// also the only thread that may call find(), size() and snapshot(). Readers
+// on other threads load published(), an immutable snapshot the writer
+// replaces whenever it calls publish(). Readers and the writer only ever
+// contend on swapping that one pointer. This is not lock-free: the standard
+// library may guard std::atomic<std::shared_ptr> with an internal lock, and
+// libstdc++ does.
+template<typename Policy = detail::strict_version_parsing_policy>
+class latest_versions final {
+public:
+    using version_type = version<Policy>;
+
+    struct entry final {
+        std::optional<version_type> latest_stable;
+        std::optional<version_type> latest_prerelease;
+
+        // Latest stable release keyed by major, packages rarely have many.
+        std::map<std::uint64_t, version_type> latest_per_major;
+    };
+
+    using snapshot_type = std::vector<std::pair<std::string, entry>>;
+
+    latest_versions() = default;
+    ~latest_versions() = default;
+
+    latest_versions(const latest_versions& other)
+        : packages_(other.packages_)
+        , published_(other.published_.load()) {}
+
+    latest_versions(latest_versions&& other) noexcept
+        : packages_(std::move(other.packages_))
+        , published_(other.published_.exchange(nullptr)) {}
+
+    latest_versions&
+    operator=(const latest_versions& other) {
+        if (this != &other) {
+            packages_ = other.packages_;
+            published_.store(other.published_.load());
+        }
+
+        return *this;
+    }
+
+    latest_versions&
+    operator=(latest_versions&& other) noexcept {
+        if (this != &other) {
+            packages_ = std::move(other.packages_);
+            published_.store(other.published_.exchange(nullptr));
+        }
+
+        return *this;
+    }
+
+    // Records a publish event, returns true if any tracked version changed.
+    bool
+    update(std::string_view package, const version_type& published) {
+        auto found = packages_.find(package);
+        if (found == packages_.end())
+            found = packages_.emplace(std::string{ package }, entry{}).first;
+
+        auto& state = found->second;
+        if (!published.pre().empty())
+            return promote(state.latest_prerelease, published);
+
+        bool changed = promote(state.latest_stable, published);
+        auto major   = state.latest_per_major.find(published.major());
+        if (major == state.latest_per_major.end()) {
+            state.latest_per_major.emplace(published.major(), published);
+            return true;
+        }
+
+        if (major->second < published) {
+            major->second = published;
+            changed = true;
+        }
+
+        return changed;
+    }
+
+    const entry*
+    find(std::string_view package) const {
+        auto found = packages_.find(package);
+        return found != packages_.end() ? &found->second : nullptr;
+    }
+
+    std::size_t
+    size() const noexcept {
+        return packages_.size();
+    }
+
+    // Copies the current state ordered by package name.
+    snapshot_type
+    snapshot() const {
+        snapshot_type result(packages_.begin(), packages_.end());
+        std::sort(result.begin(), result.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.first < rhs.first;
+        });
+
+        return result;
+    }
+
+    // Replaces the snapshot seen by readers with the current state. Costs a
+    // full copy, so writers publish at their own cadence, not per update.
+    void
+    publish() {
+        published_.store(std::make_shared<const snapshot_type>(snapshot()));
+    }
+
+    // Last published snapshot, safe to call from any thread. Readers keep
+    // the snapshot alive for as long as they hold it, null until the first
+    // publish().
+    std::shared_ptr<const snapshot_type>
+    published() const noexcept {
+        return published_.load();
+    }
+
+private:
+    static bool
+    promote(std::optional<version_type>& current,
+            const version_type& candidate) {
+        if (current && !(*current < candidate))
+            return false;
+
+        current = candidate;
+        return true;
+    }
+
+private:
+    std::unordered_map<std::string,
+                       entry,
+                       detail::package_name_hash,
+                       std::equal_to<>> packages_;
+    std::atomic<std::shared_ptr<const snapshot_type>> published_;
+};
+
+
+} // namespace sk
+
+#endif // SK_SEMVER_LATEST_HPP
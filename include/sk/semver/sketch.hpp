@@ -0,0 +1,270 @@
+#ifndef SK_SEMVER_SKETCH_HPP
+#define SK_SEMVER_SKETCH_HPP
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "sk/semver.hpp"
+
+
+namespace sk {
+
+
+// HyperLogLog estimate of the number of distinct versions in a stream. Uses
+// 2^Precision bytes regardless of the stream length, the standard error is
+// about 1.04 / sqrt(2^Precision). Sketches built on separate threads or
+// machines merge losslessly.
+template<std::size_t Precision = 12>
+class version_cardinality_sketch final {
+    static_assert(Precision >= 4 && Precision <= 18,
+                  "Precision must be between 4 and 18.");
+
+public:
+    constexpr static std::size_t kRegisters = std::size_t{ 1 } << Precision;
+
+    using registers_type = std::array<std::uint8_t, kRegisters>;
+
+    constexpr version_cardinality_sketch() = default;
+    constexpr explicit version_cardinality_sketch(const registers_type& registers) noexcept
+        : registers_(registers) {}
+
+    template<typename Version>
+    constexpr void
+    add(const Version& value) noexcept {
+        add_hash(value.hash());
+    }
+
+    constexpr void
+    add_hash(std::uint64_t hash) noexcept {
+        const auto index = static_cast<std::size_t>(hash >> (64 - Precision));
+
+        // The sentinel bit bounds the rank when the remaining bits are zero.
+        const auto rest = (hash << Precision) | (std::uint64_t{ 1 } << (Precision - 1));
+        const auto rank = static_cast<std::uint8_t>(std::countl_zero(rest) + 1);
+        registers_[index] = std::max(registers_[index], rank);
+    }
+
+    constexpr void
+    merge(const version_cardinality_sketch& other) noexcept {
+        for (std::size_t index = 0; index < kRegisters; ++index)
+            registers_[index] = std::max(registers_[index], other.registers_[index]);
+    }
+
+    double
+    estimate() const noexcept {
+        constexpr double kCount = static_cast<double>(kRegisters);
+        const double alpha = 0.7213 / (1.0 + 1.079 / kCount);
+
+        double sum = 0.0;
+        std::size_t zeros = 0;
+        for (auto value : registers_) {
+            sum   += std::ldexp(1.0, -static_cast<int>(value));
+            zeros += value == 0;
+        }
+
+        // Small cardinalities are better served by linear counting, the
+        // 64-bit hash makes a large range correction unnecessary.
+        const double raw = alpha * kCount * kCount / sum;
+        if (raw <= 2.5 * kCount && zeros != 0)
+            return kCount * std::log(kCount / static_cast<double>(zeros));
+
+        return raw;
+    }
+
+    // Raw registers, for shipping a sketch to wherever it gets merged.
+    constexpr const registers_type&
+    registers() const noexcept {
+        return registers_;
+    }
+
+private:
+    registers_type registers_{};
+};
+
+
+
+// KLL quantile sketch over a stream of versions, answering questions like
+// "which version is at the 5th percentile of the fleet". Keeps O(k log n)
+// versions, with rank error of roughly 1.7 / k. Sketches merge, so shards of
+// a stream can be summarised in parallel and combined afterwards.
+template<typename Version = version<>>
+class version_quantile_sketch final {
+public:
+    explicit version_quantile_sketch(std::size_t k = 200,
+                                     std::uint64_t seed = 0x9e3779b97f4a7c15ull)
+        : k_(std::max<std::size_t>(k, 8))
+        , state_(seed | 1)
+        , levels_(1) {
+        capacity_ = capacity(0);
+    }
+
+    void
+    add(const Version& value) {
+        levels_.front().push_back(value);
+        ++count_;
+        if (++retained_ >= capacity_)
+            compress();
+    }
+
+    void
+    merge(const version_quantile_sketch& other) {
+        // Merging into itself would insert a level into that same level.
+        if (&other == this) {
+            const auto copy = other;
+            merge(copy);
+            return;
+        }
+
+        while (levels_.size() < other.levels_.size())
+            grow();
+
+        for (std::size_t level = 0; level < other.levels_.size(); ++level) {
+            auto& items = levels_[level];
+            items.insert(items.end(), other.levels_[level].begin(), other.levels_[level].end());
+        }
+
+        count_    += other.count_;
+        retained_ += other.retained_;
+        while (retained_ >= capacity_)
+            compress();
+    }
+
+    std::uint64_t
+    count() const noexcept {
+        return count_;
+    }
+
+    bool
+    empty() const noexcept {
+        return count_ == 0;
+    }
+
+    // Smallest retained version whose estimated rank reaches fraction.
+    Version
+    quantile(double fraction) const {
+        if (empty())
+            throw std::out_of_range("Quantile of an empty sketch");
+
+        const auto weighted = sorted();
+        std::uint64_t total = 0;
+        for (const auto& item : weighted)
+            total += item.second;
+
+        const double target = std::clamp(fraction, 0.0, 1.0) * static_cast<double>(total);
+        std::uint64_t seen = 0;
+        for (const auto& item : weighted) {
+            seen += item.second;
+            if (static_cast<double>(seen) >= target)
+                return *item.first;
+        }
+
+        return *weighted.back().first;
+    }
+
+    // Estimated fraction of the stream that has lower precedence than value.
+    double
+    rank(const Version& value) const {
+        if (empty())
+            return 0.0;
+
+        std::uint64_t below = 0;
+        std::uint64_t total = 0;
+        for (std::size_t level = 0; level < levels_.size(); ++level) {
+            const std::uint64_t weight = std::uint64_t{ 1 } << level;
+            for (const auto& item : levels_[level]) {
+                total += weight;
+                if (item < value) below += weight;
+            }
+        }
+
+        return static_cast<double>(below) / static_cast<double>(total);
+    }
+
+private:
+    // Lower levels shrink geometrically so most space goes to heavy items.
+    std::size_t
+    capacity(std::size_t level) const {
+        const auto depth = static_cast<double>(levels_.size() - level - 1);
+        const auto size  = std::ceil(static_cast<double>(k_) * std::pow(2.0 / 3.0, depth));
+        return std::max<std::size_t>(2, static_cast<std::size_t>(size));
+    }
+
+    void
+    grow() {
+        levels_.emplace_back();
+        capacity_ = 0;
+        for (std::size_t level = 0; level < levels_.size(); ++level)
+            capacity_ += capacity(level);
+    }
+
+    bool
+    coin() noexcept {
+        // xorshift64, only one bit of quality is needed.
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 7;
+        state_ ^= state_ << 17;
+        return state_ & 1;
+    }
+
+    // Halves the first full level by promoting every other sorted item,
+    // an odd item out stays behind so the total weight is preserved.
+    void
+    compress() {
+        for (std::size_t level = 0; level < levels_.size(); ++level) {
+            if (levels_[level].size() < capacity(level))
+                continue;
+
+            if (level + 1 == levels_.size())
+                grow();
+
+            auto& items = levels_[level];
+            std::sort(items.begin(), items.end());
+
+            const std::size_t pairs = items.size() / 2;
+            const std::size_t offset = coin() ? 1 : 0;
+            auto& next = levels_[level + 1];
+            for (std::size_t index = 0; index < pairs; ++index)
+                next.push_back(std::move(items[2 * index + offset]));
+
+            if (items.size() % 2 != 0)
+                items.front() = std::move(items.back());
+            items.resize(items.size() % 2);
+            retained_ -= pairs;
+            return;
+        }
+    }
+
+    std::vector<std::pair<const Version*, std::uint64_t>>
+    sorted() const {
+        std::vector<std::pair<const Version*, std::uint64_t>> result;
+        result.reserve(retained_);
+        for (std::size_t level = 0; level < levels_.size(); ++level)
+            for (const auto& item : levels_[level])
+                result.emplace_back(&item, std::uint64_t{ 1 } << level);
+
+        std::sort(result.begin(), result.end(), [](const auto& lhs, const auto& rhs) {
+            return *lhs.first < *rhs.first;
+        });
+
+        return result;
+    }
+
+private:
+    std::size_t   k_;
+    std::uint64_t state_;
+    std::uint64_t count_    = 0;
+    std::size_t   retained_ = 0;
+    std::size_t   capacity_ = 0;
+
+    std::vector<std::vector<Version>> levels_;
+};
+
+
+} // namespace sk
+
+#endif // SK_SEMVER_SKETCH_HPP
@@ -0,0 +1,460 @@
+#ifndef SK_SEMVER_UPGRADE_HPP
+#define SK_SEMVER_UPGRADE_HPP
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "sk/semver.hpp"
+
+
+namespace sk {
+
+
+// Half-open interval [lower, upper) of versions, a missing bound is
+// unbounded. This is the form any range expression compiles down to, e.g.
+// ^1.2.3 is [1.2.3, 2.0.0-0) and an advisory "introduced 1.4.0, fixed
+// 1.4.7" is [1.4.0, 1.4.7).
+template<typename Version = version<>>
+struct version_interval final {
+    std::optional<Version> lower;
+    std::optional<Version> upper;
+
+    bool
+    contains(const Version& value) const noexcept {
+        return (!lower || !(value < *lower))
+            && (!upper || value < *upper);
+    }
+};
+
+
+
+// Sorted union of intervals, overlapping and adjacent intervals are merged
+// on construction so lookups are a single binary search.
+template<typename Version = version<>>
+class version_interval_set final {
+public:
+    using interval_type = version_interval<Version>;
+
+    version_interval_set() = default;
+    ~version_interval_set() = default;
+
+    version_interval_set(const version_interval_set&) = default;
+    version_interval_set(version_interval_set&&) noexcept = default;
+    version_interval_set& operator=(const version_interval_set&) = default;
+    version_interval_set& operator=(version_interval_set&&) noexcept = default;
+
+    explicit version_interval_set(std::vector<interval_type> intervals) {
+        SK_SEMVER_TIME_SCOPE(interval_build);
+        std::sort(intervals.begin(), intervals.end(), [](const auto& lhs, const auto& rhs) {
+            return lowerBefore(lhs.lower, rhs.lower);
+        });
+
+        for (auto& interval : intervals) {
+            if (interval.lower && interval.upper && !(*interval.lower < *interval.upper))
+                continue;
+
+            if (!intervals_.empty() && overlaps(intervals_.back(), interval)) {
+                auto& last = intervals_.back();
+                if (last.upper && (!interval.upper || *last.upper < *interval.upper))
+                    last.upper = std::move(interval.upper);
+                continue;
+            }
+
+            intervals_.push_back(std::move(interval));
+        }
+    }
+
+    // The merged interval containing value, or null.
+    const interval_type*
+    find(const Version& value) const noexcept {
+        SK_SEMVER_TIME_SCOPE(interval_lookup);
+        auto after = std::upper_bound(intervals_.begin(), intervals_.end(), value,
+            [](const Version& lhs, const interval_type& rhs) {
+                return rhs.lower && lhs < *rhs.lower;
+            });
+
+        if (after == intervals_.begin())
+            return nullptr;
+
+        const auto& candidate = *std::prev(after);
+        return candidate.contains(value) ? &candidate : nullptr;
+    }
+
+    // The merged interval containing value, else the first one above it, or
+    // null when there is neither.
+    const interval_type*
+    find_at_or_after(const Version& value) const noexcept {
+        auto after = std::upper_bound(intervals_.begin(), intervals_.end(), value,
+            [](const Version& lhs, const interval_type& rhs) {
+                return rhs.lower && lhs < *rhs.lower;
+            });
+
+        if (after != intervals_.begin() && std::prev(after)->contains(value))
+            return &*std::prev(after);
+
+        return after != intervals_.end() ? &*after : nullptr;
+    }
+
+    const std::vector<interval_type>&
+    intervals() const noexcept {
+        return intervals_;
+    }
+
+private:
+    static bool
+    lowerBefore(const std::optional<Version>& lhs,
+                const std::optional<Version>& rhs) noexcept {
+        return rhs && (!lhs || *lhs < *rhs);
+    }
+
+    static bool
+    overlaps(const interval_type& before, const interval_type& after) noexcept {
+        return !before.upper || !after.lower || !(*before.upper < *after.lower);
+    }
+
+private:
+    std::vector<interval_type> intervals_;
+};
+
+
+
+// Smallest version in a sorted catalog that is at least from, lies within
+// one of the allowed intervals and outside every excluded interval, or null
+// when there is none. A range with alternatives such as "^1.2 || ^2.1" is
+// one allowed interval per alternative, an empty set allows nothing. Each
+// gap between allowed intervals and each excluded interval hit skips ahead
+// with one binary search.
+template<typename Version>
+const Version*
+minimal_upgrade(const std::vector<Version>& catalog,
+                const Version& from,
+                const version_interval_set<Version>& allowed,
+                const version_interval_set<Version>& excluded) {
+    SK_SEMVER_TIME_SCOPE(upgrade);
+    auto current = std::lower_bound(catalog.begin(), catalog.end(), from);
+    while (current != catalog.end()) {
+        const auto* range = allowed.find_at_or_after(*current);
+        if (range == nullptr)
+            return nullptr;
+
+        if (range->lower && *current < *range->lower) {
+            current = std::lower_bound(current, catalog.end(), *range->lower);
+            continue;
+        }
+
+        const auto* hit = excluded.find(*current);
+        if (hit == nullptr)
+            return &*current;
+
+        if (!hit->upper)
+            return nullptr;
+
+        current = std::lower_bound(current, catalog.end(), *hit->upper);
+    }
+
+    return nullptr;
+}
+
+
+
+template<typename Version = version<>>
+struct upgrade_query final {
+    const std::vector<Version>*          catalog;
+    const version_interval_set<Version>* excluded;
+    const version_interval_set<Version>* allowed;
+    Version                              from;
+};
+
+
+namespace detail {
+
+
+constexpr std::size_t kParallelBatch = 64;
+
+
+// Calls work(begin, end) for consecutive ranges of at most kParallelBatch
+// indices covering [0, count), spread over up to threads workers that pull
+// ranges from a shared cursor, so expensive items do not hold the others
+// back. The calling thread is one of the workers. The first exception
+// thrown by any worker is rethrown once all have stopped.
+template<typename Work>
+void
+forEachBatchParallel(std::size_t count, std::size_t threads, Work&& work) {
+    constexpr std::size_t kBatch = kParallelBatch;
+
+    std::atomic<std::size_t> cursor{ 0 };
+    std::exception_ptr failure;
+    std::mutex failureMutex;
+    auto drain = [&] () noexcept {
+        try {
+            for (auto begin = cursor.fetch_add(kBatch); begin < count;
+                 begin = cursor.fetch_add(kBatch)) {
+                work(begin, std::min(begin + kBatch, count));
+            }
+        } catch (...) {
+            // Move the cursor past the end so the other workers stop early.
+            cursor.store(count);
+            std::lock_guard lock{ failureMutex };
+            if (!failure) failure = std::current_exception();
+        }
+    };
+
+    // Joins whatever was started, even when starting a later worker throws.
+    struct joiner final {
+        std::vector<std::thread>& pool;
+
+        ~joiner() {
+            for (auto& thread : pool)
+                if (thread.joinable()) thread.join();
+        }
+    };
+
+    const auto workers = std::min(std::max<std::size_t>(threads, 1),
+                                  (count + kBatch - 1) / kBatch);
+    std::vector<std::thread> pool;
+    {
+        joiner join{ pool };
+        pool.reserve(workers);
+        for (std::size_t index = 1; index < workers; ++index)
+            pool.emplace_back(drain);
+
+        drain();
+    }
+
+    if (failure)
+        std::rethrow_exception(failure);
+}
+
+
+// Calls work(index) for every index below count, as forEachBatchParallel.
+template<typename Work>
+void
+forEachParallel(std::size_t count, std::size_t threads, Work&& work) {
+    forEachBatchParallel(count, threads, [&](std::size_t begin, std::size_t end) {
+        for (auto index = begin; index < end; ++index)
+            work(index);
+    });
+}
+
+
+// max_satisfying() without the timer, for batches that time nothing per
+// lookup.
+template<typename Version>
+const Version*
+maxSatisfying(const std::vector<Version>& catalog,
+              const version_interval_set<Version>& allowed) noexcept {
+    const auto& intervals = allowed.intervals();
+    for (auto range = intervals.rbegin(); range != intervals.rend(); ++range) {
+        const auto end = range->upper
+            ? std::lower_bound(catalog.begin(), catalog.end(), *range->upper)
+            : catalog.end();
+
+        if (end != catalog.begin() && range->contains(*std::prev(end)))
+            return &*std::prev(end);
+    }
+
+    return nullptr;
+}
+
+
+inline void
+prefetch(const void* address) noexcept {
+    #if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(address);
+    #else
+        static_cast<void>(address);
+    #endif
+}
+
+
+} // namespace sk::detail
+
+
+// Answers every query in input order. Catalogs, allowed and excluded sets
+// are shared read-only, typically one of each per package or dependent.
+template<typename Version>
+std::vector<const Version*>
+minimal_upgrades(const std::vector<upgrade_query<Version>>& queries,
+                 std::size_t threads = std::thread::hardware_concurrency()) {
+    std::vector<const Version*> results(queries.size(), nullptr);
+    detail::forEachParallel(queries.size(), threads, [&](std::size_t index) {
+        const auto& query = queries[index];
+        results[index] = minimal_upgrade(*query.catalog, query.from,
+                                         *query.allowed, *query.excluded);
+    });
+
+    return results;
+}
+
+
+
+// Largest version in a sorted catalog that lies within one of the allowed
+// intervals, or null when there is none. Costs one binary search per
+// allowed interval, scanned from the top until one holds a version.
+template<typename Version>
+const Version*
+max_satisfying(const std::vector<Version>& catalog,
+               const version_interval_set<Version>& allowed) {
+    SK_SEMVER_TIME_SCOPE(max_satisfying);
+    return detail::maxSatisfying(catalog, allowed);
+}
+
+
+
+// A package's catalog and the range a lockfile entry must satisfy, resolve
+// package IDs to their catalogs before batching.
+template<typename Version = version<>>
+struct satisfying_query final {
+    const std::vector<Version>*          catalog;
+    const version_interval_set<Version>* allowed;
+};
+
+
+// Catalogs smaller than this are searched directly by the interleaved batch.
+// Such a catalog is a few cache lines that the popular packages keep warm, so
+// there are no misses to overlap and the state machine is pure overhead.
+inline constexpr std::size_t kInterleaveMinimum = 256;
+
+
+// Answers count queries into results, the same as max_satisfying() on each,
+// but interleaves up to width lookups into catalogs of kInterleaveMinimum
+// versions or more as a state machine. Every lookup takes one binary search
+// step in turn and prefetches its next probe, so the cache misses of
+// independent lookups overlap instead of being paid one after the other.
+// Lookups made here are not timed individually, their costs overlap.
+template<typename Version>
+void
+max_satisfying_interleaved(const satisfying_query<Version>* queries,
+                           std::size_t                      count,
+                           const Version**                  results,
+                           std::size_t                      width = 16) {
+    // The catalog and bound are cached so a step touches only the probe.
+    struct lookup final {
+        std::size_t    query    = 0;
+        std::size_t    interval = 0; // Intervals left to try, from the top.
+        const Version* data     = nullptr;
+        const Version* bound    = nullptr;
+        std::size_t    base     = 0;
+        std::size_t    length   = 0;
+    };
+
+    // Starts the binary search for the end of the next interval down, the
+    // first catalog entry not below its upper bound.
+    const auto start = [&](lookup& state) {
+        const auto& query = queries[state.query];
+        const auto& range = query.allowed->intervals()[state.interval - 1];
+        state.data   = query.catalog->data();
+        state.bound  = range.upper ? &*range.upper : nullptr;
+        state.base   = range.upper ? 0 : query.catalog->size();
+        state.length = range.upper ? query.catalog->size() : 0;
+        if (state.length != 0)
+            detail::prefetch(state.data + state.length / 2);
+    };
+
+    // Checks the entry below a finished search, returns false when the
+    // lookup has an answer or no intervals left.
+    const auto advance = [&](lookup& state) {
+        const auto& query = queries[state.query];
+        const auto& range = query.allowed->intervals()[state.interval - 1];
+        if (state.base != 0 && range.contains(state.data[state.base - 1])) {
+            results[state.query] = &state.data[state.base - 1];
+            return false;
+        }
+
+        if (--state.interval == 0) {
+            results[state.query] = nullptr;
+            return false;
+        }
+
+        start(state);
+        return true;
+    };
+
+    std::vector<lookup> active;
+    active.reserve(std::max<std::size_t>(width, 1));
+    std::size_t next = 0;
+    const auto refill = [&](lookup& state) {
+        while (next < count) {
+            const auto& query = queries[next];
+            state = lookup{ next, query.allowed->intervals().size(), nullptr, nullptr, 0, 0 };
+            if (state.interval != 0 && query.catalog->size() >= kInterleaveMinimum) {
+                ++next;
+                start(state);
+                return true;
+            }
+
+            results[next++] = detail::maxSatisfying(*query.catalog, *query.allowed);
+        }
+
+        return false;
+    };
+
+    while (active.size() < std::max<std::size_t>(width, 1)) {
+        lookup state;
+        if (!refill(state)) break;
+        active.push_back(state);
+    }
+
+    while (!active.empty()) {
+        for (std::size_t slot = 0; slot < active.size();) {
+            auto& state = active[slot];
+            if (state.length != 0) {
+                const auto half = state.length / 2;
+                if (state.data[state.base + half] < *state.bound) {
+                    state.base   += half + 1;
+                    state.length -= half + 1;
+                } else {
+                    state.length = half;
+                }
+
+                if (state.length != 0)
+                    detail::prefetch(state.data + state.base + state.length / 2);
+                ++slot;
+                continue;
+            }
+
+            if (advance(state) || refill(state)) {
+                ++slot;
+                continue;
+            }
+
+            state = active.back();
+            active.pop_back();
+        }
+    }
+}
+
+
+template<typename Version>
+std::vector<const Version*>
+max_satisfying_interleaved(const std::vector<satisfying_query<Version>>& queries,
+                           std::size_t width = 16) {
+    std::vector<const Version*> results(queries.size(), nullptr);
+    max_satisfying_interleaved(queries.data(), queries.size(), results.data(), width);
+    return results;
+}
+
+
+// Answers every query in input order on the same workers as
+// minimal_upgrades(), each worker interleaving the lookups of its batch, so
+// verifying a whole lockfile is one call.
+template<typename Version>
+std::vector<const Version*>
+max_satisfying_batch(const std::vector<satisfying_query<Version>>& queries,
+                     std::size_t threads = std::thread::hardware_concurrency()) {
+    std::vector<const Version*> results(queries.size(), nullptr);
+    detail::forEachBatchParallel(queries.size(), threads, [&](std::size_t begin, std::size_t end) {
+        max_satisfying_interleaved(queries.data() + begin, end - begin, results.data() + begin);
+    });
+
+    return results;
+}
+
+
+} // namespace sk
+
+#endif // SK_SEMVER_UPGRADE_HPP
@@ -0,0 +1,179 @@
+// Exports rather than imports the entry points when building on Windows.
+#define SK_SEMVER_C_BUILD
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+#include "sk/semver.hpp"
+#include "sk/semver/c_api.h"
+
+
+namespace {
+
+
+#define SK_SEMVER_CHECK_STATUS(status, error) \
+    static_assert(static_cast<int>(status) == static_cast<int>(sk::parse_error::error), \
+                  "sk_semver_status must mirror sk::parse_error.")
+
+SK_SEMVER_CHECK_STATUS(SK_SEMVER_OK,                   none);
+SK_SEMVER_CHECK_STATUS(SK_SEMVER_EMPTY,                empty);
+SK_SEMVER_CHECK_STATUS(SK_SEMVER_TOO_LONG,             too_long);
+SK_SEMVER_CHECK_STATUS(SK_SEMVER_MISSING_MAJOR,        missing_major);
+SK_SEMVER_CHECK_STATUS(SK_SEMVER_MISSING_MINOR,        missing_minor);
+SK_SEMVER_CHECK_STATUS(SK_SEMVER_MISSING_PATCH,        missing_patch);
+SK_SEMVER_CHECK_STATUS(SK_SEMVER_LEADING_ZERO,         leading_zero);
+SK_SEMVER_CHECK_STATUS(SK_SEMVER_NUMERIC_TOO_LONG,     numeric_too_long);
+SK_SEMVER_CHECK_STATUS(SK_SEMVER_NUMERIC_OVERFLOW,     numeric_overflow);
+SK_SEMVER_CHECK_STATUS(SK_SEMVER_EMPTY_IDENTIFIER,     empty_identifier);
+SK_SEMVER_CHECK_STATUS(SK_SEMVER_TOO_MANY_IDENTIFIERS, too_many_identifiers);
+SK_SEMVER_CHECK_STATUS(SK_SEMVER_PRERELEASE_TOO_LONG,  prerelease_too_long);
+SK_SEMVER_CHECK_STATUS(SK_SEMVER_BUILD_TOO_LONG,       build_too_long);
+SK_SEMVER_CHECK_STATUS(SK_SEMVER_INVALID_CHARACTER,    invalid_character);
+
+#undef SK_SEMVER_CHECK_STATUS
+
+
+sk_semver_status
+parseOne(std::string_view text, sk_semver_flags flags, sk_semver& out) noexcept {
+    sk::detail::version_fields fields;
+    const auto error = flags & SK_SEMVER_LOOSE
+        ? sk::detail::scanVersion<sk::detail::loose_version_parsing_policy>(text, fields)
+        : sk::detail::scanVersion<sk::detail::strict_version_parsing_policy>(text, fields);
+
+    if (error != sk::parse_error::none) {
+        out = sk_semver{};
+        return static_cast<sk_semver_status>(error);
+    }
+
+    out.major             = fields.major;
+    out.minor             = fields.minor;
+    out.patch             = fields.patch;
+    out.prerelease        = text.data() + fields.prerelease_offset;
+    out.prerelease_length = fields.prerelease_length;
+    out.build             = text.data() + fields.build_offset;
+    out.build_length      = fields.build_length;
+    return SK_SEMVER_OK;
+}
+
+
+int
+compareOne(const sk_semver& lhs, const sk_semver& rhs) noexcept {
+    if (lhs.major != rhs.major) return lhs.major < rhs.major ? -1 : 1;
+    if (lhs.minor != rhs.minor) return lhs.minor < rhs.minor ? -1 : 1;
+    if (lhs.patch != rhs.patch) return lhs.patch < rhs.patch ? -1 : 1;
+
+    // A version without a prerelease has higher precedence.
+    const bool lhsRelease = lhs.prerelease_length == 0;
+    const bool rhsRelease = rhs.prerelease_length == 0;
+    if (lhsRelease || rhsRelease)
+        return lhsRelease == rhsRelease ? 0 : (lhsRelease ? 1 : -1);
+
+    return sk::detail::compareIdentifiers({ lhs.prerelease, lhs.prerelease_length },
+                                          { rhs.prerelease, rhs.prerelease_length });
+}
+
+
+bool
+containsOne(const sk_semver_interval& interval, const sk_semver& value) noexcept {
+    return (!interval.lower || compareOne(value, *interval.lower) >= 0)
+        && (!interval.upper || compareOne(value, *interval.upper) < 0);
+}
+
+
+} // namespace
+
+
+extern "C" {
+
+
+size_t
+sk_semver_parse_n(const char* const* texts,
+                  const size_t*      lengths,
+                  size_t             count,
+                  sk_semver_flags    flags,
+                  sk_semver*         out,
+                  sk_semver_status*  status) {
+    size_t parsed = 0;
+    for (size_t index = 0; index < count; ++index) {
+        const std::string_view text = lengths
+            ? std::string_view{ texts[index], lengths[index] }
+            : std::string_view{ texts[index] };
+
+        status[index] = parseOne(text, flags, out[index]);
+        parsed += status[index] == SK_SEMVER_OK;
+    }
+
+    return parsed;
+}
+
+
+size_t
+sk_semver_parse_packed(const char*       buffer,
+                       const size_t*     offsets,
+                       size_t            count,
+                       sk_semver_flags   flags,
+                       sk_semver*        out,
+                       sk_semver_status* status) {
+    size_t parsed = 0;
+    for (size_t index = 0; index < count; ++index) {
+        const std::string_view text{ buffer + offsets[index],
+                                     offsets[index + 1] - offsets[index] };
+
+        status[index] = parseOne(text, flags, out[index]);
+        parsed += status[index] == SK_SEMVER_OK;
+    }
+
+    return parsed;
+}
+
+
+void
+sk_semver_compare_n(const sk_semver* lhs,
+                    const sk_semver* rhs,
+                    size_t           count,
+                    int*             result) {
+    for (size_t index = 0; index < count; ++index)
+        result[index] = compareOne(lhs[index], rhs[index]);
+}
+
+
+void
+sk_semver_in_intervals_n(const sk_semver*          versions,
+                         size_t                    count,
+                         const sk_semver_interval* intervals,
+                         size_t                    interval_count,
+                         int*                      result) {
+    for (size_t index = 0; index < count; ++index) {
+        const auto* end = intervals + interval_count;
+        result[index] = std::any_of(intervals, end, [&](const auto& interval) {
+            return containsOne(interval, versions[index]);
+        });
+    }
+}
+
+
+void
+sk_semver_sort(sk_semver* versions, size_t count) {
+    std::stable_sort(versions, versions + count, [](const auto& lhs, const auto& rhs) {
+        return compareOne(lhs, rhs) < 0;
+    });
+}
+
+
+void
+sk_semver_argsort(const sk_semver* versions, size_t count, size_t* indices) {
+    std::iota(indices, indices + count, size_t{ 0 });
+    std::stable_sort(indices, indices + count, [versions](size_t lhs, size_t rhs) {
+        return compareOne(versions[lhs], versions[rhs]) < 0;
+    });
+}
+
+
+const char*
+sk_semver_status_string(sk_semver_status status) {
+    return sk::describe(static_cast<sk::parse_error>(status));
+}
+
+
+} // extern "C"
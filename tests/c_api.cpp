@@ -0,0 +1,164 @@
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+
+#include "sk/semver/c_api.h"
+
+
+static std::string_view
+view(const char* text, size_t length) {
+    return { text, length };
+}
+
+
+static bool
+zeroed(const sk_semver& value) {
+    return value.major == 0 && value.minor == 0 && value.patch == 0 &&
+           value.prerelease == nullptr && value.prerelease_length == 0 &&
+           value.build == nullptr && value.build_length == 0;
+}
+
+
+static void
+testParse() {
+    const char* texts[] = { "1.2.3-rc.1+b.7", "01.0.0", "", "v1", "1.0.0-a..b" };
+    constexpr size_t kCount = std::size(texts);
+
+    sk_semver out[kCount];
+    sk_semver_status status[kCount];
+    std::memset(out, 0xff, sizeof(out));
+    assert(sk_semver_parse_n(texts, nullptr, kCount, SK_SEMVER_STRICT, out, status) == 1);
+
+    assert(status[0] == SK_SEMVER_OK);
+    assert(out[0].major == 1 && out[0].minor == 2 && out[0].patch == 3);
+    assert(view(out[0].prerelease, out[0].prerelease_length) == "rc.1");
+    assert(view(out[0].build, out[0].build_length) == "b.7");
+
+    assert(status[1] == SK_SEMVER_LEADING_ZERO);
+    assert(status[2] == SK_SEMVER_EMPTY);
+    assert(status[3] == SK_SEMVER_MISSING_MAJOR);
+    assert(status[4] == SK_SEMVER_EMPTY_IDENTIFIER);
+    for (size_t index = 1; index < kCount; ++index)
+        assert(zeroed(out[index]));
+
+    // Explicit lengths need not stop at a NUL, loose parsing fills in parts.
+    const size_t lengths[] = { 5, 6, 0, 2, 1 };
+    assert(sk_semver_parse_n(texts, lengths, kCount, SK_SEMVER_LOOSE, out, status) == 3);
+    assert(status[0] == SK_SEMVER_OK && out[0].prerelease_length == 0);
+    assert(status[1] == SK_SEMVER_LEADING_ZERO);
+    assert(status[2] == SK_SEMVER_EMPTY);
+    assert(status[3] == SK_SEMVER_OK && out[3].major == 1 && out[3].minor == 0);
+    assert(status[4] == SK_SEMVER_OK && out[4].major == 1);
+
+    const char   buffer[]  = "1.0.02.0.0-beta11.2";
+    const size_t offsets[] = { 0, 5, 16, 19 };
+    sk_semver packed[3];
+    sk_semver_status packedStatus[3];
+    assert(sk_semver_parse_packed(buffer, offsets, 3, SK_SEMVER_STRICT, packed, packedStatus) == 2);
+    assert(packedStatus[0] == SK_SEMVER_OK && packed[0].major == 1);
+    assert(packedStatus[1] == SK_SEMVER_OK && packed[1].major == 2);
+    assert(view(packed[1].prerelease, packed[1].prerelease_length) == "beta1");
+    assert(packedStatus[2] == SK_SEMVER_MISSING_PATCH && zeroed(packed[2]));
+
+    assert(std::strcmp(sk_semver_status_string(SK_SEMVER_LEADING_ZERO),
+                       "Leading zero in numeric identifier") == 0);
+}
+
+
+static void
+testCompare() {
+    const char* lhsTexts[] = { "1.0.0", "1.0.0-rc.1", "1.0.0-beta.11", "1.0.0+a", "2.0.0" };
+    const char* rhsTexts[] = { "1.0.1", "1.0.0",      "1.0.0-beta.2",  "1.0.0+b", "1.9.9" };
+    constexpr size_t kCount = std::size(lhsTexts);
+
+    sk_semver lhs[kCount];
+    sk_semver rhs[kCount];
+    sk_semver_status status[kCount];
+    assert(sk_semver_parse_n(lhsTexts, nullptr, kCount, SK_SEMVER_STRICT, lhs, status) == kCount);
+    assert(sk_semver_parse_n(rhsTexts, nullptr, kCount, SK_SEMVER_STRICT, rhs, status) == kCount);
+
+    int result[kCount];
+    sk_semver_compare_n(lhs, rhs, kCount, result);
+    assert(result[0] == -1 && result[1] == -1 && result[2] == 1);
+    assert(result[3] == 0 && result[4] == 1);
+}
+
+
+static void
+testSort() {
+    // Equal precedence that differs only in build meta shows the stability.
+    const char* texts[] = { "2.0.0", "1.0.0+b", "1.0.0-rc.1", "1.0.0+a", "1.0.0+c", "0.1.0" };
+    constexpr size_t kCount = std::size(texts);
+
+    sk_semver versions[kCount];
+    sk_semver_status status[kCount];
+    assert(sk_semver_parse_n(texts, nullptr, kCount, SK_SEMVER_STRICT, versions, status) == kCount);
+
+    size_t indices[kCount];
+    sk_semver_argsort(versions, kCount, indices);
+    const size_t expected[] = { 5, 2, 1, 3, 4, 0 };
+    for (size_t index = 0; index < kCount; ++index)
+        assert(indices[index] == expected[index]);
+
+    sk_semver_sort(versions, kCount);
+    const char* builds[] = { "b", "a", "c" };
+    for (size_t index = 0; index < 3; ++index) {
+        const auto& value = versions[index + 2];
+        assert(view(value.build, value.build_length) == builds[index]);
+    }
+
+    assert(versions[0].major == 0 && versions[1].prerelease_length == 4);
+    assert(versions[kCount - 1].major == 2);
+}
+
+
+static void
+testIntervals() {
+    // "^1.2.0 || >=3.0.0-rc.1" followed by an empty and an unbounded interval.
+    const char* boundTexts[] = { "1.2.0", "2.0.0-0", "3.0.0-rc.1", "4.0.0" };
+    sk_semver bounds[std::size(boundTexts)];
+    sk_semver_status boundStatus[std::size(boundTexts)];
+    assert(sk_semver_parse_n(boundTexts, nullptr, std::size(boundTexts), SK_SEMVER_STRICT,
+                             bounds, boundStatus) == std::size(boundTexts));
+
+    const sk_semver_interval intervals[] = {
+        { &bounds[2], nullptr },
+        { &bounds[0], &bounds[1] },
+        { &bounds[3], &bounds[3] },
+    };
+
+    const char* texts[] = { "1.1.9", "1.2.0", "1.9.9+b", "2.0.0-alpha", "2.0.0",
+                            "3.0.0-beta", "3.0.0-rc.1", "9.0.0" };
+    constexpr size_t kCount = std::size(texts);
+
+    sk_semver versions[kCount];
+    sk_semver_status status[kCount];
+    assert(sk_semver_parse_n(texts, nullptr, kCount, SK_SEMVER_STRICT, versions, status) == kCount);
+
+    int result[kCount];
+    sk_semver_in_intervals_n(versions, kCount, intervals, std::size(intervals), result);
+    const int expected[] = { 0, 1, 1, 0, 0, 0, 1, 1 };
+    for (size_t index = 0; index < kCount; ++index)
+        assert(result[index] == expected[index]);
+
+    // No intervals allow nothing, a fully unbounded one allows everything.
+    sk_semver_in_intervals_n(versions, kCount, intervals, 0, result);
+    for (size_t index = 0; index < kCount; ++index)
+        assert(result[index] == 0);
+
+    const sk_semver_interval everything{ nullptr, nullptr };
+    sk_semver_in_intervals_n(versions, kCount, &everything, 1, result);
+    for (size_t index = 0; index < kCount; ++index)
+        assert(result[index] == 1);
+}
+
+
+int main() {
+    testParse();
+    testCompare();
+    testIntervals();
+    testSort();
+    return EXIT_SUCCESS;
+}
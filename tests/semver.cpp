@@ -1,6 +1,677 @@
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 #include "sk/semver.hpp"
+#include "sk/semver/arrow.hpp"
+#include "sk/semver/known_versions.hpp"
+#include "sk/semver/latest.hpp"
+#include "sk/semver/sketch.hpp"
+#include "sk/semver/upgrade.hpp"
+
+
+static void
+testPrecedence() {
+    using sk::prerelease;
+    using version = sk::version<>;
+
+    // Ordering example from the semver 2.0.0 specification.
+    const version ordered[] = {
+        { 1, 0, 0, prerelease::parse("alpha") },
+        { 1, 0, 0, prerelease::parse("alpha.1") },
+        { 1, 0, 0, prerelease::parse("alpha.beta") },
+        { 1, 0, 0, prerelease::parse("beta") },
+        { 1, 0, 0, prerelease::parse("beta.2") },
+        { 1, 0, 0, prerelease::parse("beta.11") },
+        { 1, 0, 0, prerelease::parse("rc.1") },
+        { 1, 0, 0 },
+        { 1, 0, 1 },
+        { 1, 1, 0 },
+        { 2, 0, 0 },
+    };
+
+    for (std::size_t index = 1; index < std::size(ordered); ++index)
+        assert(ordered[index - 1] < ordered[index]);
+
+    assert(version(1, 0, 0, {}, sk::build_meta::parse("a")) ==
+           version(1, 0, 0, {}, sk::build_meta::parse("b")));
+}
+
+
+template<typename Policy = sk::detail::strict_version_parsing_policy>
+static bool
+rejects(std::string_view text) {
+    try {
+        sk::version<Policy>::parse(text);
+        return false;
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+}
+
+
+static void
+testParse() {
+    using loose = sk::detail::loose_version_parsing_policy;
+
+    const auto parsed = sk::version<>::parse("1.2.3-rc.1+build.05");
+    assert(parsed.major() == 1 && parsed.minor() == 2 && parsed.patch() == 3);
+    assert(parsed.pre().str() == "rc.1");
+    assert(parsed.build().str() == "build.05");
+    assert(parsed.str() == "1.2.3-rc.1+build.05");
+    assert(sk::version<>::parse("1.0.0-0a.1").pre().str() == "0a.1");
+    assert(sk::version<>::parse("18446744073709551615.0.0").major() == 18446744073709551615ull);
+
+    assert(sk::version<loose>::parse("v1").str() == "1.0.0");
+    assert(sk::version<loose>::parse("1.2-beta+exp").str() == "1.2.0-beta+exp");
+
+    for (auto text : { "", "1", "1.2", "v1.2.3", "01.2.3", "1.2.3-", "1.2.3-01",
+                       "1.2.3+", "1.2.3-a..b", "1.2.3 ", "1.2.3-a_b",
+                       "18446744073709551616.0.0" })
+        assert(rejects(text));
+
+    assert(rejects<loose>("1."));
+    assert(rejects(std::string(1 << 20, '1')));
+    assert(rejects("1.0.0-" + std::string(100 * 1024, 'a')));
+
+    // A moved-from version is left as the default version and stays usable.
+    static_assert(std::is_nothrow_move_constructible_v<sk::version<>>);
+    static_assert(std::is_nothrow_move_assignable_v<sk::version<>>);
+    auto source = sk::version<>::parse("1.2.3-rc.1+build.5");
+    const auto moved = std::move(source);
+    assert(source.hash() == sk::version<>{}.hash());
+    assert(source == sk::version<>{} && source < moved);
+    assert(source.str() == "0.0.0" && source.pre().empty() && source.build().empty());
+
+    auto target = sk::version<>::parse("2.0.0-beta+x");
+    target = std::move(source);
+    assert(target == sk::version<>{} && source.hash() == sk::version<>{}.hash());
+    source = moved;
+    assert(source.pre().str() == "rc.1");
+}
+
+
+static void
+testStaticVersion() {
+    using small = sk::static_version<16>;
+
+    static_assert(std::is_trivially_copyable_v<small>);
+    static_assert(small::parse("1.0.0-alpha.1") < small::parse("1.0.0-alpha.beta"));
+    static_assert(small::parse("1.0.0-beta.11") > small::parse("1.0.0-beta.2"));
+    static_assert(small::parse("1.0.0-rc.1") < small{ 1, 0, 0 });
+    static_assert(small::parse("1.0.0+a") == small::parse("1.0.0+b"));
+
+    constexpr auto known = small::parse("2.1.0-rc.1+b.7");
+    static_assert(known.major() == 2 && known.minor() == 1);
+
+    const auto converted = known.to_version();
+    assert(converted.str() == "2.1.0-rc.1+b.7");
+    assert(small{ converted } == known);
+
+    bool threw = false;
+    try {
+        small::parse("1.0.0-" + std::string(17, 'a'));
+    } catch (const std::length_error&) {
+        threw = true;
+    }
+
+    assert(threw);
+
+    // Views built without parse() are checked before they are copied in, by
+    // both version types alike.
+    const auto rejectsView = [](auto&& make) {
+        try {
+            make();
+            return false;
+        } catch (const std::invalid_argument&) {
+            return true;
+        }
+    };
+
+    for (auto text : { "....", "a..b", "01", "a_b" }) {
+        assert(rejectsView([text] { sk::static_version<4>{ 1, 0, 0, sk::prerelease{ text } }; }));
+        assert(rejectsView([text] { sk::version<>{ 1, 0, 0, sk::prerelease{ text } }; }));
+    }
+
+    for (auto text : { "a..b", "a_b", "." }) {
+        assert(rejectsView([text] { sk::static_version<4>{ 1, 0, 0, {}, sk::build_meta{ text } }; }));
+        assert(rejectsView([text] { sk::version<>{ 1, 0, 0, {}, sk::build_meta{ text } }; }));
+    }
+
+    assert((sk::version<>{ 1, 0, 0, sk::prerelease{ "rc.1" }, sk::build_meta{ "007" } }.str() ==
+            "1.0.0-rc.1+007"));
+}
+
+
+static void
+testConstexprIdentifiers() {
+    using sk::build_meta;
+    using sk::prerelease;
+    using feature_version = sk::static_version<8>;
+
+    static_assert(prerelease::parse("alpha.1") < prerelease::parse("alpha.beta"));
+    static_assert(prerelease::parse("beta.2") < prerelease::parse("beta.11"));
+    static_assert(prerelease::parse("1") < prerelease::parse("a"));
+    static_assert(prerelease::parse("rc") < prerelease::parse("rc.1"));
+    static_assert(prerelease::parse("").empty());
+    static_assert(build_meta::parse("exp.sha.5114f85") == build_meta{ "exp.sha.5114f85" });
+
+    // Minimum supported version per feature, built at compile time.
+    constexpr feature_version kMinimums[] = {
+        { 1, 2, 0 },
+        { 1, 4, 0, prerelease::parse("rc.1") },
+        { 2, 0, 0, prerelease::parse("beta"), build_meta::parse("7") },
+    };
+
+    static_assert(kMinimums[1] < feature_version{ 1, 4, 0 });
+    static_assert(kMinimums[2].pre() == prerelease::parse("beta"));
+    static_assert(kMinimums[2].build().str() == "7");
+    assert(kMinimums[1].to_version().str() == "1.4.0-rc.1");
+}
+
+
+static void
+testLatestVersions() {
+    using sk::prerelease;
+    using version = sk::version<>;
+
+    sk::latest_versions<> latest;
+    assert(latest.update("pkg", { 1, 2, 0 }));
+    assert(latest.update("pkg", { 2, 0, 0, prerelease::parse("rc.1") }));
+    assert(latest.update("pkg", { 1, 10, 0 }));
+    assert(!latest.update("pkg", { 1, 3, 0 }));
+    assert(latest.update("pkg", { 0, 9, 0 }));
+
+    const auto* entry = latest.find("pkg");
+    assert(entry != nullptr);
+    assert(*entry->latest_stable == version(1, 10, 0));
+    assert(*entry->latest_prerelease == version(2, 0, 0, prerelease::parse("rc.1")));
+    assert(entry->latest_per_major.size() == 2);
+    assert(entry->latest_per_major.at(0) == version(0, 9, 0));
+    assert(latest.find("other") == nullptr);
+
+    // Readers only ever see whole snapshots the writer has published.
+    assert(latest.published() == nullptr);
+    latest.publish();
+    const auto published = latest.published();
+    assert(published->size() == 1 && published->front().first == "pkg");
+
+    std::thread reader{ [&latest] {
+        for (int index = 0; index < 1000; ++index) {
+            const auto current = latest.published();
+            assert(current->size() == 1 || current->size() == 2);
+        }
+    } };
+
+    for (std::uint64_t minor = 0; minor < 100; ++minor) {
+        latest.update("next", { 3, minor, 0 });
+        latest.publish();
+    }
+
+    reader.join();
+    assert(published->size() == 1);
+    const auto latestPublished = latest.published();
+    assert(latestPublished->size() == 2 && latestPublished->front().first == "next");
+    assert(*latestPublished->front().second.latest_stable == version(3, 99, 0));
+}
+
+
+static void
+testUpgrades() {
+    using version  = sk::version<>;
+    using interval = sk::version_interval<version>;
+    using set      = sk::version_interval_set<version>;
+
+    // Adjacent and overlapping intervals merge, empty ones are dropped.
+    const set merged{ {
+        { version(3, 0, 0), version(4, 0, 0) },
+        { version(1, 2, 0), version(1, 5, 0) },
+        { version(1, 0, 0), version(1, 2, 0) },
+        { version(1, 4, 0), version(2, 0, 0) },
+        { version(5, 0, 0), version(5, 0, 0) },
+    } };
+    assert(merged.intervals().size() == 2);
+    assert(*merged.intervals()[0].lower == version(1, 0, 0));
+    assert(*merged.intervals()[0].upper == version(2, 0, 0));
+    assert(merged.find(version(1, 9, 9)) == &merged.intervals()[0]);
+    assert(merged.find(version(2, 0, 0)) == nullptr);
+    assert(merged.find(version(0, 9, 0)) == nullptr);
+
+    const set unbounded{ { { version(2, 0, 0), std::nullopt }, { version(6, 0, 0), version(7, 0, 0) } } };
+    assert(unbounded.intervals().size() == 1 && !unbounded.intervals()[0].upper);
+
+    std::vector<version> catalog;
+    for (std::uint64_t major = 1; major <= 3; ++major)
+        for (std::uint64_t minor = 0; minor < 10; ++minor)
+            catalog.emplace_back(major, minor, 0);
+
+    const set anything{ { interval{} } };
+    const set nothing;
+
+    // From below the allowed range starts at its lower bound.
+    const set caret14{ { { version(1, 4, 0), version(2, 0, 0) } } };
+    assert(*sk::minimal_upgrade(catalog, version(1, 0, 0), caret14, nothing) == version(1, 4, 0));
+    assert(sk::minimal_upgrade(catalog, version(2, 0, 0), caret14, nothing) == nullptr);
+    assert(sk::minimal_upgrade(catalog, version(1, 0, 0), nothing, nothing) == nullptr);
+
+    // Excluded intervals are skipped, an unbounded one ends the search.
+    const set advisories{ {
+        { version(1, 4, 0), version(1, 6, 0) },
+        { version(1, 8, 0), std::nullopt },
+    } };
+    assert(*sk::minimal_upgrade(catalog, version(1, 4, 0), anything, advisories) == version(1, 6, 0));
+    assert(sk::minimal_upgrade(catalog, version(1, 8, 0), anything, advisories) == nullptr);
+
+    // "~1.2 || ^2.5" jumps the gap between alternatives.
+    const set alternatives{ {
+        { version(1, 2, 0), version(1, 3, 0) },
+        { version(2, 5, 0), version(3, 0, 0) },
+    } };
+    const set fixes{ { { version(2, 5, 0), version(2, 7, 0) } } };
+    assert(*sk::minimal_upgrade(catalog, version(1, 2, 0), alternatives, nothing) == version(1, 2, 0));
+    assert(*sk::minimal_upgrade(catalog, version(1, 3, 0), alternatives, nothing) == version(2, 5, 0));
+    assert(*sk::minimal_upgrade(catalog, version(1, 3, 0), alternatives, fixes) == version(2, 7, 0));
+    assert(sk::minimal_upgrade(catalog, version(3, 0, 0), alternatives, nothing) == nullptr);
+
+    // Batched answers come back in input order whatever thread found them.
+    const set* allowedSets[] = { &anything, &caret14, &alternatives };
+    std::vector<sk::upgrade_query<version>> queries;
+    for (std::size_t index = 0; index < 1000; ++index)
+        queries.push_back({ &catalog, &advisories, allowedSets[index % 3],
+                            catalog[index % catalog.size()] });
+
+    const auto results = sk::minimal_upgrades(queries, 4);
+    assert(results.size() == queries.size());
+    for (std::size_t index = 0; index < queries.size(); ++index) {
+        const auto& query = queries[index];
+        assert(results[index] == sk::minimal_upgrade(catalog, query.from,
+                                                     *query.allowed, advisories));
+    }
+
+    // The highest allowed interval holding a version answers max_satisfying.
+    const set gap{ { { version(1, 2, 1), version(1, 3, 0) } } };
+    const set future{ { { version(4, 0, 0), std::nullopt } } };
+    assert(*sk::max_satisfying(catalog, anything) == version(3, 9, 0));
+    assert(*sk::max_satisfying(catalog, caret14) == version(1, 9, 0));
+    assert(*sk::max_satisfying(catalog, alternatives) == version(2, 9, 0));
+    assert(sk::max_satisfying(catalog, gap) == nullptr);
+    assert(sk::max_satisfying(catalog, future) == nullptr);
+    assert(sk::max_satisfying(catalog, nothing) == nullptr);
+
+    // Interleaved lookups fall through empty top intervals and empty
+    // catalogs the same way, whatever the number in flight. Only catalogs of
+    // kInterleaveMinimum versions go through the state machine.
+    const set fallback{ { { version(1, 2, 0), version(1, 3, 0) }, { version(3, 9, 1), version(5, 0, 0) } } };
+    const std::vector<version> empty;
+    std::vector<version> large;
+    for (std::uint64_t major = 0; major < 10; ++major) {
+        for (std::uint64_t minor = 0; minor < 60; ++minor) {
+            large.emplace_back(major, minor, 0, sk::prerelease{ "rc.1" });
+            large.emplace_back(major, minor, 0);
+        }
+    }
+    assert(large.size() >= sk::kInterleaveMinimum);
+    assert(*sk::max_satisfying(large, fallback) == version(5, 0, 0, sk::prerelease{ "rc.1" }));
+
+    const std::vector<version>* catalogs[] = { &catalog, &large, &empty, &large };
+    const set* rangeSets[] = { &anything, &caret14, &alternatives, &gap, &future, &nothing, &fallback };
+    std::vector<sk::satisfying_query<version>> lockfile;
+    for (std::size_t index = 0; index < 1000; ++index)
+        lockfile.push_back({ catalogs[index % std::size(catalogs)],
+                             rangeSets[index % std::size(rangeSets)] });
+
+    assert(*sk::max_satisfying(catalog, fallback) == version(1, 2, 0));
+    for (const std::size_t width : { 0, 1, 3, 16, 2000 }) {
+        const auto interleaved = sk::max_satisfying_interleaved(lockfile, width);
+        assert(interleaved.size() == lockfile.size());
+        for (std::size_t index = 0; index < lockfile.size(); ++index) {
+            const auto& query = lockfile[index];
+            assert(interleaved[index] == sk::max_satisfying(*query.catalog, *query.allowed));
+        }
+    }
+
+    const auto satisfying = sk::max_satisfying_batch(lockfile, 4);
+    assert(satisfying.size() == lockfile.size());
+    for (std::size_t index = 0; index < lockfile.size(); ++index) {
+        const auto& query = lockfile[index];
+        assert(satisfying[index] == sk::max_satisfying(*query.catalog, *query.allowed));
+    }
+}
+
+
+static void
+testArrowExport() {
+    using sk::build_meta;
+    using sk::prerelease;
+    using version = sk::version<>;
+
+    const std::vector<version> versions = {
+        { 1, 2, 3 },
+        { 1, 0, 0, prerelease::parse("rc.1"), build_meta::parse("b7") },
+        { 2, 0, 0, prerelease::parse("rc.1") },
+        { 3, 0, 0, {}, build_meta::parse("b7") },
+    };
+
+    ArrowSchema schema{};
+    ArrowArray  array{};
+    sk::export_arrow(versions.begin(), versions.end(), &schema, &array);
+
+    assert(std::string_view{ schema.format } == "+s" && schema.n_children == 5);
+    assert(std::string_view{ schema.children[1]->name } == "minor");
+    assert(std::string_view{ schema.children[1]->format } == "L");
+    assert(std::string_view{ schema.children[4]->name } == "build");
+    assert(std::string_view{ schema.children[4]->format } == "i");
+    assert(schema.children[4]->flags == ARROW_FLAG_NULLABLE);
+    assert(std::string_view{ schema.children[4]->dictionary->format } == "u");
+
+    assert(array.length == 4 && array.null_count == 0 && array.n_children == 5);
+    const auto* minors = static_cast<const std::uint64_t*>(array.children[1]->buffers[1]);
+    assert(array.children[1]->null_count == 0 && minors[0] == 2 && minors[1] == 0);
+
+    // Both text columns are null where a version has no such part.
+    const std::uint8_t validity[] = { 0b0110, 0b1010 };
+    for (std::size_t column = 3; column < 5; ++column) {
+        const auto& indices = *array.children[column];
+        assert(indices.length == 4 && indices.null_count == 2);
+
+        const auto* bits = static_cast<const std::uint8_t*>(indices.buffers[0]);
+        assert(bits[0] == validity[column - 3]);
+
+        const auto* rows = static_cast<const std::int32_t*>(indices.buffers[1]);
+        for (std::size_t row = 0; row < 4; ++row)
+            assert(!(bits[0] >> row & 1) || rows[row] == 0);
+
+        const auto& dictionary = *indices.dictionary;
+        const auto* offsets = static_cast<const std::int32_t*>(dictionary.buffers[1]);
+        const auto* text    = static_cast<const char*>(dictionary.buffers[2]);
+        assert(dictionary.length == 1 && dictionary.null_count == 0);
+        assert(offsets[0] == 0);
+        assert(std::string_view(text, offsets[1]) == (column == 3 ? "rc.1" : "b7"));
+    }
+
+    // Consumers may move a child out and release it after its parent.
+    ArrowSchema movedSchema = *schema.children[3];
+    schema.children[3]->release = nullptr;
+    ArrowArray movedArray = *array.children[3];
+    array.children[3]->release = nullptr;
+
+    schema.release(&schema);
+    array.release(&array);
+    assert(schema.release == nullptr && array.release == nullptr);
+
+    assert(std::string_view{ movedSchema.dictionary->format } == "u");
+    const auto* text = static_cast<const char*>(movedArray.dictionary->buffers[2]);
+    assert(std::string_view(text, 4) == "rc.1");
+    movedSchema.release(&movedSchema);
+    movedArray.release(&movedArray);
+    assert(movedSchema.release == nullptr && movedArray.release == nullptr);
+}
+
+
+static void
+testSketches() {
+    using version = sk::version<>;
+
+    // Distinct versions sort in the order of i, which makes true ranks known.
+    constexpr std::uint64_t kCount = 20000;
+    const auto nth = [](std::uint64_t index) {
+        return version(index / 1000, index / 10 % 100, index % 10);
+    };
+
+    sk::version_cardinality_sketch<> all, lower, upper;
+    for (std::uint64_t index = 0; index < kCount; ++index) {
+        all.add(nth(index));
+        all.add(nth(index));
+        (index < kCount * 3 / 4 ? lower : upper).add(nth(index));
+        if (index >= kCount / 4) upper.add(nth(index));
+    }
+
+    assert(std::abs(all.estimate() / kCount - 1.0) < 0.05);
+    lower.merge(upper);
+    assert(lower.registers() == all.registers());
+    assert(sk::version_cardinality_sketch<>{}.estimate() == 0.0);
+
+    // Fed in a scrambled order so compaction sees an unsorted stream.
+    sk::version_quantile_sketch<version> first, second;
+    for (std::uint64_t step = 0; step < kCount; ++step) {
+        const auto index = step * 7919 % kCount;
+        (step % 2 ? first : second).add(nth(index));
+    }
+
+    first.merge(second);
+    assert(first.count() == kCount);
+    for (double fraction : { 0.01, 0.05, 0.25, 0.5, 0.9, 0.99 }) {
+        const auto found = first.quantile(fraction);
+        const auto index = found.major() * 1000 + found.minor() * 10 + found.patch();
+        assert(std::abs(static_cast<double>(index) / kCount - fraction) < 0.03);
+
+        const auto value = nth(static_cast<std::uint64_t>(fraction * kCount));
+        assert(std::abs(first.rank(value) - fraction) < 0.03);
+    }
+
+    second.merge(second);
+    assert(second.count() == kCount);
+    assert(std::abs(second.rank(nth(kCount / 2)) - 0.5) < 0.03);
+}
+
+
+static void
+testKnownVersions() {
+    using sk::known_version_set;
+    using version = sk::version<>;
+
+    std::vector<version> versions;
+    for (std::uint64_t minor = 0; minor < 500; ++minor) {
+        versions.emplace_back(1, minor, 0);
+        versions.emplace_back(1, minor, 0, sk::prerelease::parse("rc.1"));
+    }
+
+    const auto member = [](std::uint64_t minor, bool candidate) {
+        return candidate ? version(1, minor, 0, sk::prerelease::parse("rc.1"))
+                         : version(1, minor, 0);
+    };
+
+    // Duplicates collapse, build meta is ignored, every member hits and
+    // nothing else does.
+    versions.push_back(versions.front());
+    versions.emplace_back(1, 0, 0, sk::prerelease{}, sk::build_meta::parse("b.1"));
+    const auto set = known_version_set::build(versions);
+    assert(set.size() == 1000);
+    for (std::uint64_t minor = 0; minor < 500; ++minor) {
+        assert(set.contains(member(minor, false)) && set.contains(member(minor, true)));
+        assert(!set.contains(version(2, minor, 0)));
+        assert(!set.contains(version(1, minor, 0, sk::prerelease::parse("rc.2"))));
+    }
+
+    // Tables wrapped in place, as a generated header does, behave the same.
+    const known_version_set wrapped{ set.displacements(), set.keys(), set.size(), set.text() };
+    assert(wrapped.contains(member(42, true)) && !wrapped.contains(version(0, 0, 1)));
+
+    // A matching fingerprint alone is not membership, the text must match.
+    const auto single = known_version_set::build(std::vector{ member(0, true) });
+    auto forged = *single.keys();
+    forged.prerelease = sk::detail::fnv1a("rc.2");
+    const known_version_set colliding{ single.displacements(), &forged, 1, single.text() };
+    assert(!colliding.contains(version(1, 0, 0, sk::prerelease::parse("rc.2"))));
+
+    const auto directory = std::filesystem::temp_directory_path();
+    const auto path = (directory / "sk_semver_test.skvs").string();
+    set.save(path);
+    const auto loaded = known_version_set::load(path);
+    assert(loaded.size() == set.size());
+    for (std::uint64_t minor = 0; minor < 500; ++minor)
+        assert(loaded.contains(member(minor, true)) && !loaded.contains(version(3, minor, 0)));
+
+    const auto empty = known_version_set::build(std::vector<version>{});
+    assert(empty.size() == 0 && !empty.contains(version(1, 0, 0)));
+    empty.save(path);
+    assert(known_version_set::load(path).size() == 0);
+
+    // Truncated files and files with out of range slots are rejected.
+    const auto rejects = [&path] {
+        try {
+            known_version_set::load(path);
+            return false;
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+    };
+
+    set.save(path);
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    assert(rejects());
+
+    set.save(path);
+    std::size_t slot = 0;
+    while (set.displacements()[slot] >= 0) ++slot;
+    {
+        const std::int32_t corrupt = -static_cast<std::int32_t>(set.size()) - 1;
+        // The displacements follow the magic, format, size and text size.
+        constexpr std::size_t kHeader = 4 + sizeof(std::uint32_t) + 2 * sizeof(std::uint64_t);
+        std::fstream out{ path, std::ios::binary | std::ios::in | std::ios::out };
+        out.seekp(static_cast<std::streamoff>(kHeader + slot * sizeof(std::int32_t)));
+        out.write(reinterpret_cast<const char*>(&corrupt), sizeof(corrupt));
+    }
+    assert(rejects());
+
+    // A key whose text lies outside the pool is rejected as well.
+    set.save(path);
+    {
+        constexpr std::size_t kHeader = 4 + sizeof(std::uint32_t) + 2 * sizeof(std::uint64_t);
+        const auto keys = kHeader + set.size() * sizeof(std::int32_t);
+        const std::uint32_t corrupt = static_cast<std::uint32_t>(set.text().size()) + 1;
+        std::fstream out{ path, std::ios::binary | std::ios::in | std::ios::out };
+        out.seekp(static_cast<std::streamoff>(keys + offsetof(sk::version_key, text_length)));
+        out.write(reinterpret_cast<const char*>(&corrupt), sizeof(corrupt));
+    }
+    assert(rejects());
+    std::filesystem::remove(path);
+}
+
+
+#ifdef SK_SEMVER_HISTOGRAMS
+static void
+testHistograms() {
+    namespace histograms = sk::histograms;
+    using histograms::bucketLimit;
+    using histograms::bucketOf;
+    using histograms::metric;
+
+    for (std::uint64_t nanos = 0; nanos < histograms::kSubBuckets; ++nanos)
+        assert(bucketOf(nanos) == nanos && bucketLimit(nanos) == nanos + 1);
+
+    // Every value falls below its bucket's limit and at or above the last one.
+    for (std::uint64_t nanos = 1; nanos < histograms::kMaxValue; nanos = nanos * 3 + 1) {
+        const auto bucket = bucketOf(nanos);
+        assert(nanos < bucketLimit(bucket));
+        assert(bucketLimit(bucket - 1) <= nanos);
+        assert(bucketOf(nanos - 1) <= bucket);
+    }
+
+    assert(bucketOf(histograms::kMaxValue) == histograms::kBuckets - 1);
+    assert(bucketOf(~std::uint64_t{ 0 }) == histograms::kBuckets - 1);
+
+    // Samples from other threads are merged into the same snapshot.
+    const auto before = histograms::collect(metric::interval_build);
+    for (int index = 0; index < 99; ++index)
+        histograms::record(metric::interval_build, 50);
+    std::thread{ [] { histograms::record(metric::interval_build, 5000); } }.join();
+
+    const auto after = histograms::collect(metric::interval_build);
+    assert(after.count - before.count == 100);
+    assert(after.sum - before.sum == 99 * 50 + 5000);
+
+    // Exited threads are folded into one total instead of piling up.
+    const auto live = [] {
+        auto& global = histograms::detail::globalRegistry();
+        std::lock_guard lock{ global.mutex };
+        return global.threads.size();
+    };
+
+    const auto threads = live();
+    for (int index = 0; index < 50; ++index)
+        std::thread{ [] { histograms::record(metric::interval_build, 7); } }.join();
+    assert(live() == threads);
+    assert(histograms::collect(metric::interval_build).count - after.count == 50);
+
+    histograms::snapshot uniform;
+    uniform.counts[bucketOf(50)] = 10;
+    uniform.count = 10;
+    assert(uniform.percentile(1.0) == bucketLimit(bucketOf(50)));
+    assert(uniform.percentile(0.0) == bucketLimit(bucketOf(50)));
+    assert(histograms::snapshot{}.percentile(0.5) == 0);
+
+    uniform.counts[bucketOf(5000)] = 1;
+    uniform.count = 11;
+    assert(uniform.percentile(0.9) == bucketLimit(bucketOf(50)));
+    assert(uniform.percentile(1.0) == bucketLimit(bucketOf(5000)));
+
+    // Nested timers are sampled independently of each other.
+    const auto outer = histograms::collect(metric::upgrade).count;
+    const auto inner = histograms::collect(metric::interval_lookup).count;
+    histograms::set_sample_every(2);
+    for (int index = 0; index < 100; ++index) {
+        histograms::scoped_timer upgrade{ metric::upgrade };
+        histograms::scoped_timer lookup{ metric::interval_lookup };
+    }
+    histograms::set_sample_every(1);
+    assert(histograms::collect(metric::upgrade).count - outer == 50);
+    assert(histograms::collect(metric::interval_lookup).count - inner == 50);
+
+    // Catalog lookups are timed on their own as well as within upgrades.
+    using version = sk::version<>;
+    const std::vector<version> catalog = { { 1, 0, 0 }, { 1, 1, 0 }, { 2, 0, 0 } };
+    const sk::version_interval_set<version> caret1{ { { version(1, 0, 0), version(2, 0, 0) } } };
+    const auto lookups = histograms::collect(metric::max_satisfying).count;
+    for (int index = 0; index < 10; ++index)
+        assert(*sk::max_satisfying(catalog, caret1) == version(1, 1, 0));
+    assert(histograms::collect(metric::max_satisfying).count - lookups == 10);
+
+    const auto path = (std::filesystem::temp_directory_path() / "sk_semver_test.prom").string();
+    assert(histograms::write_prometheus(path));
+    assert(!std::filesystem::exists(path + ".tmp"));
+
+    std::ifstream in{ path };
+    const std::string text{ std::istreambuf_iterator<char>{ in }, {} };
+    const auto count = histograms::collect(metric::interval_build).count;
+    assert(text.find("# TYPE sk_semver_latency_ns histogram\n") != std::string::npos);
+    assert(text.find("sk_semver_latency_ns_count{op=\"interval_build\"} " +
+                     std::to_string(count) + "\n") != std::string::npos);
+    assert(text.find("sk_semver_latency_ns_bucket{op=\"interval_build\",le=\"+Inf\"} " +
+                     std::to_string(count) + "\n") != std::string::npos);
+    assert(text.find("sk_semver_latency_ns_count{op=\"max_satisfying\"} ") != std::string::npos);
+    assert(text.find("sk_semver_latency_sample_every 1\n") != std::string::npos);
+    std::filesystem::remove(path);
+}
+#endif
+
 
-int main(int argc, char** argv) {
-    
+int main() {
+    testPrecedence();
+    testParse();
+    testStaticVersion();
+    testConstexprIdentifiers();
+    testLatestVersions();
+    testUpgrades();
+    testArrowExport();
+    testSketches();
+    testKnownVersions();
+#ifdef SK_SEMVER_HISTOGRAMS
+    testHistograms();
+#endif
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
@@ -0,0 +1,123 @@
+// Builds a known version set from a list of versions, one per line, and
+// writes it either as a binary file for known_version_set::load or as a
+// header that compiles the tables in.
+//
+//   semver_phf <versions.txt> --binary <out.skvs>
+//   semver_phf <versions.txt> --header <out.hpp> [--name kKnownVersions]
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "sk/semver.hpp"
+#include "sk/semver/known_versions.hpp"
+
+
+namespace {
+
+
+void
+writeHeader(const sk::known_version_set& set,
+            const std::string& path,
+            const std::string& name) {
+    std::FILE* out = std::fopen(path.c_str(), "w");
+    if (out == nullptr)
+        throw std::runtime_error("Failed to open " + path);
+
+    std::fprintf(out, "// Generated by semver_phf, do not edit.\n");
+    std::fprintf(out, "#pragma once\n#include \"sk/semver/known_versions.hpp\"\n\n");
+
+    // Zero length arrays are ill-formed, an empty set needs no tables.
+    if (set.size() == 0) {
+        std::fprintf(out, "inline const sk::known_version_set %s{};\n", name.c_str());
+        if (std::fclose(out) != 0)
+            throw std::runtime_error("Failed to write " + path);
+        return;
+    }
+
+    std::fprintf(out, "inline constexpr std::int32_t %sDisplacements[] = {", name.c_str());
+    for (std::size_t index = 0; index < set.size(); ++index)
+        std::fprintf(out, "%s%" PRId32 ",", index % 12 ? " " : "\n    ", set.displacements()[index]);
+
+    std::fprintf(out, "\n};\n\ninline constexpr sk::version_key %sKeys[] = {\n", name.c_str());
+    for (std::size_t index = 0; index < set.size(); ++index) {
+        const auto& key = set.keys()[index];
+        std::fprintf(out, "    { %" PRIu64 "u, %" PRIu64 "u, %" PRIu64 "u, 0x%016" PRIx64 "u, %" PRIu32 "u, %" PRIu32 "u },\n",
+                     key.major, key.minor, key.patch, key.prerelease,
+                     key.text_offset, key.text_length);
+    }
+
+    // Emitted as character codes rather than a string literal, which some
+    // compilers cap at 64 KiB. The trailing zero keeps the array non-empty.
+    const auto text = set.text();
+    std::fprintf(out, "};\n\ninline constexpr char %sText[] = {", name.c_str());
+    for (std::size_t index = 0; index < text.size(); ++index)
+        std::fprintf(out, "%s%d,", index % 16 ? " " : "\n    ", text[index]);
+
+    std::fprintf(out, "%s0\n};\n\ninline const sk::known_version_set %s{\n"
+                      "    %sDisplacements, %sKeys, %zu, { %sText, %zu }\n};\n",
+                 text.size() % 16 ? " " : "\n    ",
+                 name.c_str(), name.c_str(), name.c_str(), set.size(), name.c_str(), text.size());
+
+    if (std::fclose(out) != 0)
+        throw std::runtime_error("Failed to write " + path);
+}
+
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    if (argc < 4) {
+        std::fprintf(stderr, "usage: %s <versions> (--binary <out> | --header <out> [--name <id>])\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const std::string mode = argv[2];
+    const std::string output = argv[3];
+    const std::string name = argc > 5 && std::string{ argv[4] } == "--name"
+        ? argv[5]
+        : "kKnownVersions";
+
+    try {
+        // A missing or unreadable list must not turn into an empty set.
+        std::ifstream in{ argv[1] };
+        if (!in)
+            throw std::runtime_error(std::string{ "Failed to open " } + argv[1]);
+
+        std::vector<sk::version<>> versions;
+        std::string line;
+        for (std::size_t number = 1; std::getline(in, line); ++number) {
+            if (line.empty() || line[0] == '#')
+                continue;
+
+            try {
+                versions.push_back(sk::version<>::parse(line));
+            } catch (const std::invalid_argument& error) {
+                std::fprintf(stderr, "%s:%zu: %s\n", argv[1], number, error.what());
+                return EXIT_FAILURE;
+            }
+        }
+
+        if (in.bad())
+            throw std::runtime_error(std::string{ "Failed to read " } + argv[1]);
+
+        const auto set = sk::known_version_set::build(versions);
+        if (mode == "--binary")
+            set.save(output);
+        else if (mode == "--header")
+            writeHeader(set, output, name);
+        else
+            throw std::invalid_argument("Unknown output mode " + mode);
+
+        std::fprintf(stderr, "%zu versions written to %s\n", set.size(), output.c_str());
+    } catch (const std::exception& error) {
+        std::fprintf(stderr, "%s\n", error.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}